@@ -59,12 +59,19 @@ namespace houseofatmos::engine {
         std::vector<Animation::Skeleton> skeletons;
         std::unordered_map<std::string, std::tuple<size_t, size_t, std::optional<size_t>>> meshes;
         std::unordered_map<std::string, Animation> animations;
+        Vec<3> bounding_center;
+        f64 bounding_radius = INFINITY;
 
         Model();
 
         public:
         FaceCulling face_culling = FaceCulling::Enabled;
 
+        // sphere containing all primitives in their default pose
+        // (infinite radius if the bounds of any primitive are unknown)
+        const Vec<3>& bounds_center() const { return this->bounding_center; }
+        f64 bounds_radius() const { return this->bounding_radius; }
+
         static Model from_resource(const LoadArgs& args);
         Model(const Model& other) = delete;
         Model(Model&& other) = default;
@@ -90,23 +97,45 @@ namespace houseofatmos::engine {
         
         void render_all(
             Shader& shader, RenderTarget dest,
-            std::optional<std::string_view> local_transform_uniform = std::nullopt,
-            std::optional<std::string_view> texture_uniform = std::nullopt,
-            std::optional<std::string_view> joint_transform_uniform = std::nullopt,
+            std::optional<Shader::Uniform> local_transform_uniform = std::nullopt,
+            std::optional<Shader::Uniform> texture_uniform = std::nullopt,
+            std::optional<Shader::Uniform> joint_transform_uniform = std::nullopt,
+            size_t count = 1,
+            FaceCulling face_culling = FaceCulling::Enabled,
+            DepthTesting depth_testing = DepthTesting::Enabled,
+            const InstanceBuffer* instances = nullptr,
+            size_t first_instance = 0
+        );
+
+        // the joint transforms of each skeleton (indexed by skeleton)
+        std::vector<std::vector<Mat<4>>> compute_poses(
+            const Animation& animation, f64 timestamp
+        ) const;
+
+        void render_all_posed(
+            Shader& shader, RenderTarget dest,
+            std::span<const std::vector<Mat<4>>> poses,
+            const Shader::Uniform& joint_transform_uniform,
+            std::optional<Shader::Uniform> local_transform_uniform = std::nullopt,
+            std::optional<Shader::Uniform> texture_uniform = std::nullopt,
             size_t count = 1,
             FaceCulling face_culling = FaceCulling::Enabled,
-            DepthTesting depth_testing = DepthTesting::Enabled
+            DepthTesting depth_testing = DepthTesting::Enabled,
+            const InstanceBuffer* instances = nullptr,
+            size_t first_instance = 0
         );
 
         void render_all_animated(
             Shader& shader, RenderTarget dest,
             const Animation& animation, f64 timestamp,
-            std::string_view joint_transform_uniform,
-            std::optional<std::string_view> local_transform_uniform = std::nullopt,
-            std::optional<std::string_view> texture_uniform = std::nullopt,
+            const Shader::Uniform& joint_transform_uniform,
+            std::optional<Shader::Uniform> local_transform_uniform = std::nullopt,
+            std::optional<Shader::Uniform> texture_uniform = std::nullopt,
             size_t count = 1,
             FaceCulling face_culling = FaceCulling::Enabled,
-            DepthTesting depth_testing = DepthTesting::Enabled
+            DepthTesting depth_testing = DepthTesting::Enabled,
+            const InstanceBuffer* instances = nullptr,
+            size_t first_instance = 0
         );
 
     };
@@ -7,6 +7,7 @@
 #include <vector>
 #include <span>
 #include <unordered_map>
+#include <functional>
 #include <utility>
 #include <list>
 #include <memory>
@@ -224,15 +225,39 @@ namespace houseofatmos::engine {
             }
         };
 
+        // Uniform of a shader, either given by name or already resolved
+        // to its location. Resolved uniforms are only valid for the shader
+        // that resolved them (see 'Shader::resolve_uniform').
+        struct Uniform {
+            std::string_view name;
+            i64 location = -1;
+
+            Uniform(const char* name): name(name) {}
+            Uniform(std::string_view name): name(name) {}
+            Uniform(const std::string& name): name(name) {}
+            Uniform(std::string_view name, i64 location)
+                : name(name), location(location) {}
+        };
+
         private:
         struct Handles {
             u64 vert_id, frag_id, prog_id;
         };
         static void destruct(const Handles& handles);
 
+        struct NameHash {
+            using is_transparent = void;
+            size_t operator()(std::string_view name) const {
+                return std::hash<std::string_view>()(name);
+            }
+        };
+
         util::Handle<Handles, &destruct> handles;
-        // <uniform name> -> <tex id>
-        std::unordered_map<std::string, u64> uniform_textures;
+        // <uniform name> -> <uniform location>, collected after linking
+        std::unordered_map<std::string, i64, NameHash, std::equal_to<>> 
+            uniform_locations;
+        // <uniform location> -> <tex id>
+        std::unordered_map<i64, u64> uniform_textures;
         // <tex id> -> <count of uniforms using it>
         std::unordered_map<u64, u64> texture_uniform_count;
         // <tex id> -> <tex slot>
@@ -241,7 +266,9 @@ namespace houseofatmos::engine {
         std::list<u64> free_tex_slots;
         u64 next_slot;
 
-        u64 allocate_texture_slot(std::string name, u64 tex_id, bool is_array);
+        void collect_uniform_locations();
+        i64 binded_uniform_loc(const Uniform& uniform);
+        u64 allocate_texture_slot(i64 location, u64 tex_id, bool is_array);
 
 
         public:
@@ -253,58 +280,59 @@ namespace houseofatmos::engine {
         static Shader from_resource(const LoadArgs& args);
 
         void internal_bind() const;
-        void internal_unbind() const;
  
         static size_t max_textures();
 
-        void set_uniform(std::string_view name, const Texture& texture);
-        void set_uniform(std::string_view name, const TextureArray& textures);
-
-        void set_uniform(std::string_view name, f64 value);
-        void set_uniform(std::string_view name, Vec<2> value);
-        void set_uniform(std::string_view name, Vec<3> value);
-        void set_uniform(std::string_view name, Vec<4> value);
-        void set_uniform(std::string_view name, std::span<const f64> value);
-        void set_uniform(std::string_view name, std::span<const Vec<2>> value);
-        void set_uniform(std::string_view name, std::span<const Vec<3>> value);
-        void set_uniform(std::string_view name, std::span<const Vec<4>> value);
-
-        void set_uniform(std::string_view name, i64 value);
-        void set_uniform(std::string_view name, IVec<2> value);
-        void set_uniform(std::string_view name, IVec<3> value);
-        void set_uniform(std::string_view name, IVec<4> value);
-        void set_uniform(std::string_view name, std::span<const i64> value);
-        void set_uniform(std::string_view name, std::span<const IVec<2>> value);
-        void set_uniform(std::string_view name, std::span<const IVec<3>> value);
-        void set_uniform(std::string_view name, std::span<const IVec<4>> value);
-
-        void set_uniform(std::string_view name, u64 value);
-        void set_uniform(std::string_view name, UVec<2> value);
-        void set_uniform(std::string_view name, UVec<3> value);
-        void set_uniform(std::string_view name, UVec<4> value);
-        void set_uniform(std::string_view name, std::span<const u64> value);
-        void set_uniform(std::string_view name, std::span<const UVec<2>> value);
-        void set_uniform(std::string_view name, std::span<const UVec<3>> value);
-        void set_uniform(std::string_view name, std::span<const UVec<4>> value);
-
-        void set_uniform(std::string_view name, const Mat<2>& value);
-        void set_uniform(std::string_view name, const Mat<3>& value);
-        void set_uniform(std::string_view name, const Mat<4>& value);
-        void set_uniform(std::string_view name, const Mat<2, 3>& value);
-        void set_uniform(std::string_view name, const Mat<3, 2>& value);
-        void set_uniform(std::string_view name, const Mat<2, 4>& value);
-        void set_uniform(std::string_view name, const Mat<4, 2>& value);
-        void set_uniform(std::string_view name, const Mat<3, 4>& value);
-        void set_uniform(std::string_view name, const Mat<4, 3>& value);
-        void set_uniform(std::string_view name, std::span<const Mat<2>> value);
-        void set_uniform(std::string_view name, std::span<const Mat<3>> value);
-        void set_uniform(std::string_view name, std::span<const Mat<4>> value);
-        void set_uniform(std::string_view name, std::span<const Mat<2, 3>> value);
-        void set_uniform(std::string_view name, std::span<const Mat<3, 2>> value);
-        void set_uniform(std::string_view name, std::span<const Mat<2, 4>> value);
-        void set_uniform(std::string_view name, std::span<const Mat<4, 2>> value);
-        void set_uniform(std::string_view name, std::span<const Mat<3, 4>> value);
-        void set_uniform(std::string_view name, std::span<const Mat<4, 3>> value);
+        Uniform resolve_uniform(std::string_view name);
+
+        void set_uniform(const Uniform& uniform, const Texture& texture);
+        void set_uniform(const Uniform& uniform, const TextureArray& textures);
+
+        void set_uniform(const Uniform& uniform, f64 value);
+        void set_uniform(const Uniform& uniform, Vec<2> value);
+        void set_uniform(const Uniform& uniform, Vec<3> value);
+        void set_uniform(const Uniform& uniform, Vec<4> value);
+        void set_uniform(const Uniform& uniform, std::span<const f64> value);
+        void set_uniform(const Uniform& uniform, std::span<const Vec<2>> value);
+        void set_uniform(const Uniform& uniform, std::span<const Vec<3>> value);
+        void set_uniform(const Uniform& uniform, std::span<const Vec<4>> value);
+
+        void set_uniform(const Uniform& uniform, i64 value);
+        void set_uniform(const Uniform& uniform, IVec<2> value);
+        void set_uniform(const Uniform& uniform, IVec<3> value);
+        void set_uniform(const Uniform& uniform, IVec<4> value);
+        void set_uniform(const Uniform& uniform, std::span<const i64> value);
+        void set_uniform(const Uniform& uniform, std::span<const IVec<2>> value);
+        void set_uniform(const Uniform& uniform, std::span<const IVec<3>> value);
+        void set_uniform(const Uniform& uniform, std::span<const IVec<4>> value);
+
+        void set_uniform(const Uniform& uniform, u64 value);
+        void set_uniform(const Uniform& uniform, UVec<2> value);
+        void set_uniform(const Uniform& uniform, UVec<3> value);
+        void set_uniform(const Uniform& uniform, UVec<4> value);
+        void set_uniform(const Uniform& uniform, std::span<const u64> value);
+        void set_uniform(const Uniform& uniform, std::span<const UVec<2>> value);
+        void set_uniform(const Uniform& uniform, std::span<const UVec<3>> value);
+        void set_uniform(const Uniform& uniform, std::span<const UVec<4>> value);
+
+        void set_uniform(const Uniform& uniform, const Mat<2>& value);
+        void set_uniform(const Uniform& uniform, const Mat<3>& value);
+        void set_uniform(const Uniform& uniform, const Mat<4>& value);
+        void set_uniform(const Uniform& uniform, const Mat<2, 3>& value);
+        void set_uniform(const Uniform& uniform, const Mat<3, 2>& value);
+        void set_uniform(const Uniform& uniform, const Mat<2, 4>& value);
+        void set_uniform(const Uniform& uniform, const Mat<4, 2>& value);
+        void set_uniform(const Uniform& uniform, const Mat<3, 4>& value);
+        void set_uniform(const Uniform& uniform, const Mat<4, 3>& value);
+        void set_uniform(const Uniform& uniform, std::span<const Mat<2>> value);
+        void set_uniform(const Uniform& uniform, std::span<const Mat<3>> value);
+        void set_uniform(const Uniform& uniform, std::span<const Mat<4>> value);
+        void set_uniform(const Uniform& uniform, std::span<const Mat<2, 3>> value);
+        void set_uniform(const Uniform& uniform, std::span<const Mat<3, 2>> value);
+        void set_uniform(const Uniform& uniform, std::span<const Mat<2, 4>> value);
+        void set_uniform(const Uniform& uniform, std::span<const Mat<4, 2>> value);
+        void set_uniform(const Uniform& uniform, std::span<const Mat<3, 4>> value);
+        void set_uniform(const Uniform& uniform, std::span<const Mat<4, 3>> value);
 
     };
 
@@ -314,6 +342,45 @@ namespace houseofatmos::engine {
     enum struct DepthTesting { Disabled, Enabled };
 
 
+    // Tracks the GL state set by the engine and only passes on actual
+    // changes to GL. The state tracked here must not be changed in any
+    // other way, since the tracked state would no longer be correct.
+    struct RenderState {
+
+        struct Stats {
+            u64 issued; // state changes passed on to GL
+            u64 skipped; // state changes that were already the case
+        };
+
+        static void bind_framebuffer(u64 fbo_id);
+        static void set_viewport(u64 width, u64 height);
+        static void use_program(u64 prog_id);
+        static void bind_vertex_array(u64 vao_id);
+        static void bind_array_buffer(u64 vbo_id);
+        static void bind_texture(u64 slot, u64 tex_id, bool is_array);
+        static void set_face_culling(FaceCulling face_culling);
+        static void set_depth_testing(DepthTesting depth_testing);
+
+        // GL unbinds objects once they get deleted, and IDs may be reused
+        static void deleted_framebuffer(u64 fbo_id);
+        static void deleted_program(u64 prog_id);
+        static void deleted_vertex_array(u64 vao_id);
+        static void deleted_buffer(u64 buffer_id);
+        static void deleted_texture(u64 tex_id);
+
+        static const Stats& stats();
+        static void reset_stats();
+
+    };
+
+
+    struct InstanceBuffer;
+
+
+    // The buffers of a mesh are only created once it is first submitted,
+    // meaning that meshes may be built on threads without a GL context.
+    // Elements are stored as 'u16' until a vertex index no longer fits, 
+    // after which the mesh switches to 'u32' indices.
     struct Mesh {
 
         enum AttribType {
@@ -335,7 +402,7 @@ namespace houseofatmos::engine {
 
         private:
         struct Handles {
-            u64 vbo_id, ebo_id;
+            u64 vbo_id, ebo_id, vao_id;
         };
         static void destruct(const Handles& handles);
 
@@ -346,11 +413,16 @@ namespace houseofatmos::engine {
         size_t vertices;
         size_t current_attrib;
         std::vector<u16> elements;
+        std::vector<u32> long_elements;
+        bool long_indices;
         bool modified;
+        // instance attributes currently enabled in the vertex array
+        size_t instance_attribs;
+
+        void use_long_indices();
 
         void init_buffers();
         void bind_properties() const;
-        void unbind_properties() const;
 
         public:
         Mesh(std::span<const Attrib> attributes);
@@ -375,20 +447,77 @@ namespace houseofatmos::engine {
         void put_u32(std::initializer_list<u32> values);
         void unsafe_put_raw(std::span<const u8> data);
         void unsafe_next_attr();
-        u16 complete_vertex();
+        u32 complete_vertex();
 
-        u16 vertex_count() const;
-        void add_element(u16 a, u16 b, u16 c);
+        u32 vertex_count() const;
+        void add_element(u32 a, u32 b, u32 c);
         u32 element_count() const;
+        bool has_long_indices() const { return this->long_indices; }
         void clear();
+        // Takes the vertices and elements of the given mesh (which needs to
+        // have the same attributes), but keeps the buffers of this mesh.
+        // Allows building geometry on other threads and submitting it into 
+        // existing buffers.
+        void replace_data(Mesh&& other);
 
         void submit();
+        // If instances are given, the attributes of instances 
+        // 'first_instance' to 'first_instance + count' of the buffer 
+        // are bound to the locations following the mesh attributes.
         void render(
             const Shader& shader, RenderTarget dest,
             size_t count = 1, 
             FaceCulling face_culling = FaceCulling::Enabled,
-            DepthTesting depth_testing = DepthTesting::Enabled
+            DepthTesting depth_testing = DepthTesting::Enabled,
+            const InstanceBuffer* instances = nullptr,
+            size_t first_instance = 0
+        );
+
+    };
+
+
+    // Vertex buffer of per-instance attributes streamed to the GPU.
+    // Uploads are appended after the previous ones, and only once the
+    // buffer is full it is orphaned and written from the start again,
+    // meaning uploads never have to wait for earlier draws to finish.
+    struct InstanceBuffer {
+
+        private:
+        struct Handles {
+            u64 vbo_id;
+        };
+        static void destruct(const Handles& handles);
+
+        util::Handle<Handles, &destruct> handles;
+        std::vector<Mesh::Attrib> attributes;
+        size_t instance_size;
+        size_t capacity; // in instances
+        size_t next_instance; // first instance not yet written to
+
+        void allocate(size_t capacity);
+
+        public:
+        InstanceBuffer(
+            std::span<const Mesh::Attrib> attributes, size_t capacity = 1024
         );
+        InstanceBuffer(
+            std::initializer_list<Mesh::Attrib> attributes, 
+            size_t capacity = 1024
+        );
+
+        size_t instance_size_bytes() const { return this->instance_size; }
+        size_t attribute_count() const { return this->attributes.size(); }
+
+        // 'data.size()' must be a multiple of the instance size,
+        // returns the index of the first uploaded instance
+        size_t upload(std::span<const u8> data);
+        // makes sure that the next 'count' instances can be uploaded
+        // without orphaning the instances uploaded before them
+        void reserve(size_t count);
+
+        void internal_bind_properties(
+            size_t first_location, size_t first_instance
+        ) const;
 
     };
 
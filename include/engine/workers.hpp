@@ -0,0 +1,46 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+
+namespace houseofatmos::engine {
+
+    // Runs submitted tasks on a set of background threads.
+    // Builds without thread support (the web build) instead run each task
+    // on the calling thread as soon as it is submitted.
+    struct WorkerPool {
+
+        using Task = std::function<void()>;
+
+        static size_t default_worker_count();
+
+        static WorkerPool& shared();
+
+
+        WorkerPool(size_t worker_count = default_worker_count());
+        WorkerPool(const WorkerPool& other) = delete;
+        WorkerPool(WorkerPool&& other) = delete;
+        WorkerPool& operator=(const WorkerPool& other) = delete;
+        WorkerPool& operator=(WorkerPool&& other) = delete;
+        ~WorkerPool();
+
+        void submit(Task&& task);
+
+        private:
+        #ifndef __EMSCRIPTEN__
+            std::vector<std::thread> workers;
+            std::deque<Task> tasks;
+            std::mutex tasks_lock;
+            std::condition_variable tasks_changed;
+            bool stopping = false;
+
+            void run_worker();
+        #endif
+
+    };
+
+}
@@ -0,0 +1,3 @@
+
+#define INSTANCE_ATTRIBS
+#include "geometry_vert.glsl"
@@ -5,8 +5,16 @@ layout(location = 2) in vec3 v_norm;
 layout(location = 3) in uvec4 v_joints;
 layout(location = 4) in vec4 v_weights;
 
-uniform mat4 u_view_proj;
+// model transforms are either instance attributes or a uniform array
+#ifdef INSTANCE_ATTRIBS
+layout(location = 5) in mat4 v_model_transf;
+#define MODEL_TRANSF v_model_transf
+#else
 uniform mat4 u_model_transfs[128];
+#define MODEL_TRANSF u_model_transfs[gl_InstanceID]
+#endif
+
+uniform mat4 u_view_proj;
 uniform mat4 u_local_transf;
 uniform mat4 u_joint_transfs[32];
 
@@ -21,7 +29,7 @@ void main() {
         + (u_joint_transfs[v_joints.y] * h_pos) * v_weights.y
         + (u_joint_transfs[v_joints.z] * h_pos) * v_weights.z
         + (u_joint_transfs[v_joints.w] * h_pos) * v_weights.w;
-    vec4 w_pos = u_model_transfs[gl_InstanceID] * u_local_transf * s_pos;
+    vec4 w_pos = MODEL_TRANSF * u_local_transf * s_pos;
     gl_Position = u_view_proj * w_pos;
     // apply skinning to normals
     // IMPORTANT: THIS METHOD (extracting the top left of the matrix to remove
@@ -32,7 +40,7 @@ void main() {
         + (mat3(u_joint_transfs[v_joints.y]) * v_norm) * v_weights.y
         + (mat3(u_joint_transfs[v_joints.z]) * v_norm) * v_weights.z
         + (mat3(u_joint_transfs[v_joints.w]) * v_norm) * v_weights.w;
-    vec3 t_norm = mat3(u_model_transfs[gl_InstanceID]) 
+    vec3 t_norm = mat3(MODEL_TRANSF) 
         * mat3(u_local_transf) 
         * s_norm;
     // pass to fragment shader
@@ -1,19 +1,31 @@
 
 layout(location = 0) in vec2 v_pos_uv;
 
+// particle positions and sizes are either instance attributes 
+// or uniform arrays
+#ifdef INSTANCE_ATTRIBS
+layout(location = 1) in vec3 v_w_center_pos;
+layout(location = 2) in vec2 v_size;
+#define W_CENTER_POS v_w_center_pos
+#define SIZE v_size
+#else
+uniform vec2 u_size[256];
+uniform vec3 u_w_center_pos[256];
+#define W_CENTER_POS u_w_center_pos[gl_InstanceID]
+#define SIZE u_size[gl_InstanceID]
+#endif
+
 uniform mat4 u_view_proj;
 uniform vec3 u_camera_right;
 uniform vec3 u_camera_up;
-uniform vec2 u_size[256];
-uniform vec3 u_w_center_pos[256];
 
 out vec2 f_uv;
 out vec3 f_w_pos;
 
 void main() {
     vec2 rel_offset = v_pos_uv - vec2(0.5, 0.5);
-    vec2 size = u_size[gl_InstanceID];
-    f_w_pos = u_w_center_pos[gl_InstanceID]
+    vec2 size = SIZE;
+    f_w_pos = W_CENTER_POS
         + u_camera_right * rel_offset.x * size.x
         +    u_camera_up * rel_offset.y * size.y;
     gl_Position = u_view_proj * vec4(f_w_pos, 1.0);
@@ -1,11 +1,9 @@
 
 #include "common/util.glsl"
 
-layout(location = 0) in vec3 v_pos;
-layout(location = 1) in vec2 v_uv;
-layout(location = 2) in vec3 v_norm;
-layout(location = 3) in uvec4 v_joints;
-layout(location = 4) in vec4 v_weights;
+layout(location = 0) in ivec3 v_pos;
+layout(location = 1) in ivec4 v_norm;
+layout(location = 2) in uvec2 v_uv;
 
 uniform mat4 u_view_proj;
 uniform mat4 u_transform;
@@ -17,8 +15,8 @@ const vec3 VALID_COLOR = COLOR_24(192, 199, 65);
 const vec3 ERROR_COLOR = COLOR_24(157, 48, 59);
 
 void main() {
-    gl_Position = u_view_proj * u_transform * vec4(v_pos, 1.0);
-    float diffuse = max(dot(VALID_NORM, normalize(v_norm)), 0.0);
+    gl_Position = u_view_proj * u_transform * vec4(vec3(v_pos), 1.0);
+    float diffuse = max(dot(VALID_NORM, normalize(vec3(v_norm.xyz))), 0.0);
     float is_error = step(0.01, 1.0 - diffuse);
     float is_valid = 1.0 - is_error;
     vec3 color = VALID_COLOR * is_valid + ERROR_COLOR * is_error;
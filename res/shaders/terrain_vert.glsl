@@ -0,0 +1,27 @@
+
+layout(location = 0) in ivec3 v_pos;
+layout(location = 1) in ivec4 v_norm;
+layout(location = 2) in uvec2 v_uv;
+
+uniform mat4 u_view_proj;
+uniform mat4 u_model_transf;
+
+out vec2 f_uv;
+out vec3 f_w_pos;
+out vec3 f_norm;
+
+// 'v_uv' holds the corner of the texture cell (x) and the texture cell (y),
+// where the first bit of each is the U axis and the second bit is the V axis
+const float UV_CELL_SIZE = 0.505;
+const float UV_CORNER_SIZE = 0.49;
+
+void main() {
+    vec4 w_pos = u_model_transf * vec4(vec3(v_pos), 1.0);
+    gl_Position = u_view_proj * w_pos;
+    vec2 corner = vec2(float(v_uv.x & 1u), float((v_uv.x >> 1u) & 1u));
+    vec2 cell = vec2(float(v_uv.y & 1u), float((v_uv.y >> 1u) & 1u));
+    // pass to fragment shader
+    f_uv = cell * UV_CELL_SIZE + corner * UV_CORNER_SIZE;
+    f_w_pos = w_pos.xyz;
+    f_norm = normalize(mat3(u_model_transf) * (vec3(v_norm.xyz) / 127.0));
+}
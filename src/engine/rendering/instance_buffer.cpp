@@ -0,0 +1,118 @@
+
+#include <engine/rendering.hpp>
+#include <engine/logging.hpp>
+#include <glad/gles2.h>
+
+namespace houseofatmos::engine {
+
+    void InstanceBuffer::destruct(const Handles& handles) {
+        RenderState::deleted_buffer(handles.vbo_id);
+        GLuint vbo_id = handles.vbo_id;
+        glDeleteBuffers(1, &vbo_id);
+    }
+
+    static size_t compute_instance_size(
+        const std::vector<Mesh::Attrib>& attribs
+    ) {
+        size_t sum = 0;
+        for(const Mesh::Attrib& attrib: attribs) {
+            sum += attrib.size_bytes();
+        }
+        return sum;
+    }
+
+    InstanceBuffer::InstanceBuffer(
+        std::span<const Mesh::Attrib> attributes, size_t capacity
+    ) {
+        this->attributes.assign(attributes.begin(), attributes.end());
+        this->instance_size = compute_instance_size(this->attributes);
+        if(this->instance_size == 0) {
+            error("Attempted to create an instance buffer without attributes");
+        }
+        this->capacity = 0;
+        this->next_instance = 0;
+        this->allocate(std::max(capacity, (size_t) 1));
+    }
+
+    InstanceBuffer::InstanceBuffer(
+        std::initializer_list<Mesh::Attrib> attributes, size_t capacity
+    ) {
+        *this = InstanceBuffer(std::span(attributes), capacity);
+    }
+
+    void InstanceBuffer::allocate(size_t capacity) {
+        if(this->handles.is_empty()) {
+            GLuint vbo_id;
+            glGenBuffers(1, &vbo_id);
+            this->handles = util::Handle<Handles, &InstanceBuffer::destruct>(
+                Handles(vbo_id)
+            );
+        }
+        // also orphans the previous storage, which stays alive
+        // until all draws using it are done
+        RenderState::bind_array_buffer(this->handles->vbo_id);
+        glBufferData(
+            GL_ARRAY_BUFFER, capacity * this->instance_size, 
+            nullptr, GL_STREAM_DRAW
+        );
+        this->capacity = capacity;
+        this->next_instance = 0;
+    }
+
+    size_t InstanceBuffer::upload(std::span<const u8> data) {
+        if(data.size() % this->instance_size != 0) {
+            error("Instance data of "
+                + std::to_string(data.size())
+                + " bytes does not consist of instances of "
+                + std::to_string(this->instance_size) + " bytes"
+            );
+        }
+        size_t count = data.size() / this->instance_size;
+        if(count > this->capacity) {
+            this->allocate(std::max(count, this->capacity * 2));
+        } else if(this->next_instance + count > this->capacity) {
+            this->allocate(this->capacity);
+        }
+        size_t first = this->next_instance;
+        RenderState::bind_array_buffer(this->handles->vbo_id);
+        glBufferSubData(
+            GL_ARRAY_BUFFER, first * this->instance_size, 
+            data.size(), data.data()
+        );
+        this->next_instance += count;
+        return first;
+    }
+
+    void InstanceBuffer::reserve(size_t count) {
+        if(this->next_instance + count <= this->capacity) { return; }
+        this->allocate(std::max(count, this->capacity * 2));
+    }
+
+    void InstanceBuffer::internal_bind_properties(
+        size_t first_location, size_t first_instance
+    ) const {
+        RenderState::bind_array_buffer(this->handles->vbo_id);
+        u64 offset = first_instance * this->instance_size;
+        for(u64 attr_i = 0; attr_i < this->attributes.size(); attr_i += 1) {
+            const Mesh::Attrib& attribute = this->attributes[attr_i];
+            GLuint location = first_location + attr_i;
+            glEnableVertexAttribArray(location);
+            if(attribute.type == Mesh::F32) {
+                glVertexAttribPointer(
+                    location, attribute.count, 
+                    GL_FLOAT, GL_FALSE, 
+                    this->instance_size, (void*) offset
+                );
+            } else {
+                glVertexAttribIPointer(
+                    location, attribute.count, 
+                    attribute.gl_type_constant(), 
+                    this->instance_size, (void*) offset
+                );
+            }
+            glVertexAttribDivisor(location, 1);
+            offset += attribute.size_bytes();
+        }
+    }
+
+}
@@ -62,6 +62,10 @@ namespace houseofatmos::engine {
     }
 
     void Mesh::destruct(const Handles& handles) {
+        RenderState::deleted_vertex_array(handles.vao_id);
+        GLuint vao_id = handles.vao_id;
+        glDeleteVertexArrays(1, &vao_id);
+        RenderState::deleted_buffer(handles.vbo_id);
         GLuint vbo_id = handles.vbo_id;
         glDeleteBuffers(1, &vbo_id);
         GLuint ebo_id = handles.ebo_id;
@@ -77,19 +81,13 @@ namespace houseofatmos::engine {
     }
 
     Mesh::Mesh(std::span<const Attrib> attrib_sizes) {
-        if(attrib_sizes.size() > Mesh::max_attributes()) {
-            error("Attempted to create a mesh with more attributes"
-                " than supported ("
-                + std::to_string(Mesh::max_attributes())
-                + " for this implementation)"
-            );
-        }
         this->attributes.assign(attrib_sizes.begin(), attrib_sizes.end());
         this->vertex_size = compute_vertex_size(this->attributes);
         this->vertices = 0;
         this->current_attrib = 0;
-        this->init_buffers();
+        this->long_indices = false;
         this->modified = false;
+        this->instance_attribs = 0;
     }
 
     Mesh::Mesh(std::initializer_list<Attrib> attrib_sizes) {
@@ -206,7 +204,7 @@ namespace houseofatmos::engine {
         this->current_attrib += 1;
     }
 
-    u16 Mesh::complete_vertex() {
+    u32 Mesh::complete_vertex() {
         if(this->current_attrib < this->attributes.size()) {
             const Attrib& attribute = this->attributes[this->current_attrib];
             error("Mesh expected "
@@ -214,30 +212,52 @@ namespace houseofatmos::engine {
                 + " for the current vertex, but got the end of the vertex"
             );
         }
+        if(this->vertices > UINT32_MAX) {
+            error("Attempted to add more vertices to a mesh than supported ("
+                + std::to_string((u64) UINT32_MAX + 1) + ")"
+            );
+        }
         this->current_attrib = 0;
-        u16 vertex = this->vertices;
+        u32 vertex = this->vertices;
         this->vertices += 1;
         this->modified = true;
         return vertex;
     }
 
 
-    u16 Mesh::vertex_count() const {
+    u32 Mesh::vertex_count() const {
         return this->vertices;
     }
 
-    void Mesh::add_element(u16 a, u16 b, u16 c) {
+    void Mesh::use_long_indices() {
+        this->long_elements.assign(this->elements.begin(), this->elements.end());
+        this->elements.clear();
+        this->elements.shrink_to_fit();
+        this->long_indices = true;
+    }
+
+    void Mesh::add_element(u32 a, u32 b, u32 c) {
         if(a >= this->vertices || b >= this->vertices || c >= this->vertices) {
             error("we fucked up big time");
         }
-        this->elements.push_back(a);
-        this->elements.push_back(b);
-        this->elements.push_back(c);
+        bool fits_short = a <= UINT16_MAX && b <= UINT16_MAX && c <= UINT16_MAX;
+        if(!fits_short && !this->long_indices) { this->use_long_indices(); }
+        if(this->long_indices) {
+            this->long_elements.push_back(a);
+            this->long_elements.push_back(b);
+            this->long_elements.push_back(c);
+        } else {
+            this->elements.push_back((u16) a);
+            this->elements.push_back((u16) b);
+            this->elements.push_back((u16) c);
+        }
         this->modified = true;
     }
 
     u32 Mesh::element_count() const {
-        return this->elements.size() / 3;
+        size_t indices = this->long_indices
+            ? this->long_elements.size() : this->elements.size();
+        return indices / 3;
     }
 
     void Mesh::clear() {
@@ -245,18 +265,59 @@ namespace houseofatmos::engine {
         this->vertices = 0;
         this->current_attrib = 0;
         this->elements.clear();
+        this->long_elements.clear();
+        this->long_indices = false;
         this->modified = true;
     }
 
+    void Mesh::replace_data(Mesh&& other) {
+        bool same_attributes = this->attributes.size() == other.attributes.size()
+            && std::equal(
+                this->attributes.begin(), this->attributes.end(),
+                other.attributes.begin(),
+                [](const Attrib& a, const Attrib& b) {
+                    return a.type == b.type && a.count == b.count;
+                }
+            );
+        if(!same_attributes) {
+            error("Attempted to replace the data of a mesh with the data"
+                " of a mesh with different attributes"
+            );
+        }
+        this->vertex_data = std::move(other.vertex_data);
+        this->vertices = other.vertices;
+        this->current_attrib = 0;
+        this->elements = std::move(other.elements);
+        this->long_elements = std::move(other.long_elements);
+        this->long_indices = other.long_indices;
+        this->modified = true;
+        other.clear();
+    }
+
 
     void Mesh::init_buffers() {
+        if(this->attributes.size() > Mesh::max_attributes()) {
+            error("Attempted to create a mesh with more attributes"
+                " than supported ("
+                + std::to_string(Mesh::max_attributes())
+                + " for this implementation)"
+            );
+        }
         GLuint vbo_id;
         glGenBuffers(1, &vbo_id);
         GLuint ebo_id;
         glGenBuffers(1, &ebo_id);
+        GLuint vao_id;
+        glGenVertexArrays(1, &vao_id);
         this->handles = util::Handle<Handles, &Mesh::destruct>(
-            Handles(vbo_id, ebo_id)
+            Handles(vbo_id, ebo_id, vao_id)
         );
+        // the vertex layout and the element buffer are stored in the
+        // vertex array, so they only need to be specified once
+        RenderState::bind_vertex_array(vao_id);
+        RenderState::bind_array_buffer(vbo_id);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo_id);
+        this->bind_properties();
     }
 
     void Mesh::bind_properties() const {
@@ -281,34 +342,38 @@ namespace houseofatmos::engine {
         }
     }
 
-    void Mesh::unbind_properties() const {
-        for(u64 attr = 0; attr < this->attributes.size(); attr += 1) {
-            glDisableVertexAttribArray(attr);
-        }
-    }
-
 
     void Mesh::submit() {
+        if(this->handles.is_empty()) { this->init_buffers(); }
         if(!this->modified) { return; }
-        if(this->vertices > 0 && this->elements.size() > 0) {
-            glBindBuffer(GL_ARRAY_BUFFER, this->handles->vbo_id);
+        u32 elements = this->element_count();
+        if(this->vertices > 0 && elements > 0) {
+            RenderState::bind_array_buffer(this->handles->vbo_id);
             glBufferData(
                 GL_ARRAY_BUFFER,
                 this->vertex_data.size(),
                 this->vertex_data.data(),
                 GL_STATIC_DRAW
             );
-            glBindBuffer(GL_ARRAY_BUFFER, 0);
         }
-        if(this->vertices > 0 && this->elements.size() > 0) {
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->handles->ebo_id);
-            glBufferData(
-                GL_ELEMENT_ARRAY_BUFFER,
-                this->elements.size() * sizeof(u16),
-                this->elements.data(),
-                GL_STATIC_DRAW
-            );
-            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        if(this->vertices > 0 && elements > 0) {
+            // the element buffer binding belongs to the vertex array
+            RenderState::bind_vertex_array(this->handles->vao_id);
+            if(this->long_indices) {
+                glBufferData(
+                    GL_ELEMENT_ARRAY_BUFFER,
+                    this->long_elements.size() * sizeof(u32),
+                    this->long_elements.data(),
+                    GL_STATIC_DRAW
+                );
+            } else {
+                glBufferData(
+                    GL_ELEMENT_ARRAY_BUFFER,
+                    this->elements.size() * sizeof(u16),
+                    this->elements.data(),
+                    GL_STATIC_DRAW
+                );
+            }
         }
         this->modified = false;
     }
@@ -316,44 +381,45 @@ namespace houseofatmos::engine {
     void Mesh::render(
         const Shader& shader, RenderTarget dest,
         size_t count, FaceCulling face_culling, 
-        DepthTesting depth_testing
+        DepthTesting depth_testing,
+        const InstanceBuffer* instances, size_t first_instance
     ) {
         if(count == 0) { return; }
-        if(this->modified) { this->submit(); }
-        if(face_culling == FaceCulling::Enabled) {
-            glEnable(GL_CULL_FACE);
-        }
-        if(depth_testing == DepthTesting::Enabled) { 
-            glEnable(GL_DEPTH_TEST); 
-            glCullFace(GL_BACK);
-        }
-        glBindFramebuffer(GL_FRAMEBUFFER, dest.fbo_id);
-        glViewport(0, 0, dest.width(), dest.height());
+        if(this->modified || this->handles.is_empty()) { this->submit(); }
+        RenderState::set_face_culling(face_culling);
+        RenderState::set_depth_testing(depth_testing);
+        RenderState::bind_framebuffer(dest.fbo_id);
+        RenderState::set_viewport(dest.width(), dest.height());
         shader.internal_bind();
-        glBindBuffer(GL_ARRAY_BUFFER, this->handles->vbo_id);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->handles->ebo_id);
-        this->bind_properties();
-        if(count == 1) {
-            glDrawElements(
-                GL_TRIANGLES, this->elements.size(), GL_UNSIGNED_SHORT, nullptr
+        RenderState::bind_vertex_array(this->handles->vao_id);
+        size_t instance_attribs = 0;
+        if(instances != nullptr) {
+            instances->internal_bind_properties(
+                this->attributes.size(), first_instance
             );
+            instance_attribs = instances->attribute_count();
+        }
+        // disable instance attributes left over from previous draws
+        for(
+            size_t attr_i = instance_attribs; 
+            attr_i < this->instance_attribs; 
+            attr_i += 1
+        ) {
+            GLuint location = this->attributes.size() + attr_i;
+            glVertexAttribDivisor(location, 0);
+            glDisableVertexAttribArray(location);
+        }
+        this->instance_attribs = instance_attribs;
+        GLsizei indices = this->element_count() * 3;
+        GLenum index_type = this->long_indices
+            ? GL_UNSIGNED_INT : GL_UNSIGNED_SHORT;
+        if(count == 1 && instances == nullptr) {
+            glDrawElements(GL_TRIANGLES, indices, index_type, nullptr);
         } else {
             glDrawElementsInstanced(
-                GL_TRIANGLES, this->elements.size(), GL_UNSIGNED_SHORT, nullptr, 
-                count
+                GL_TRIANGLES, indices, index_type, nullptr, count
             );
         }
-        this->unbind_properties();
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-        shader.internal_unbind();
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        if(depth_testing == DepthTesting::Enabled) { 
-            glDisable(GL_DEPTH_TEST);
-        }
-        if(face_culling == FaceCulling::Enabled) {
-            glDisable(GL_CULL_FACE);
-        }
     }
 
 }
\ No newline at end of file
@@ -238,8 +238,27 @@ namespace houseofatmos::engine {
         return ((u64) mesh_i << 32) | (u64) pmt_i;
     }
 
+    struct GltfBounds {
+        bool known;
+        Vec<3> min, max;
+    };
+
+    static GltfBounds gltf_primitive_bounds(
+        const tinygltf::Model& model, const tinygltf::Primitive& primitive
+    ) {
+        auto position = primitive.attributes.find("POSITION");
+        if(position == primitive.attributes.end()) { return { false, {}, {} }; }
+        const tinygltf::Accessor& acc = model.accessors[position->second];
+        bool known = acc.minValues.size() == 3 && acc.maxValues.size() == 3;
+        if(!known) { return { false, {}, {} }; }
+        return { 
+            true, Vec<3>(std::span(acc.minValues)), Vec<3>(std::span(acc.maxValues))
+        };
+    }
+
     static void gltf_collect_primitives(
         tinygltf::Model& model, std::vector<Model::Primitive>& primitives,
+        std::vector<GltfBounds>& primitive_bounds,
         std::unordered_map<u64, size_t>& primitive_indices,
         std::span<const std::pair<Model::Attrib, Mesh::Attrib>> attribs,
         const std::string& path
@@ -274,6 +293,9 @@ namespace houseofatmos::engine {
                 GltfBufferView indices = gltf_parse_indices(model, primitive, path);
                 primitive_indices[primitive_key(mesh_i, pmt_i)]
                     = primitives.size();
+                primitive_bounds.push_back(
+                    gltf_primitive_bounds(model, primitive)
+                );
                 primitives.push_back({
                     gltf_assemble_mesh(
                         mesh_i, attribs, attrib_data, indices
@@ -643,6 +665,45 @@ namespace houseofatmos::engine {
 
 
 
+    // animations are assumed to stay close to the default pose
+    static void compute_model_bounds(
+        const std::vector<Model::Primitive>& primitives,
+        const std::vector<GltfBounds>& primitive_bounds,
+        Vec<3>& center, f64& radius
+    ) {
+        Vec<3> min = Vec<3>(INFINITY, INFINITY, INFINITY);
+        Vec<3> max = Vec<3>(-INFINITY, -INFINITY, -INFINITY);
+        for(size_t pmt_i = 0; pmt_i < primitives.size(); pmt_i += 1) {
+            const GltfBounds& bounds = primitive_bounds[pmt_i];
+            if(!bounds.known) {
+                center = Vec<3>(0, 0, 0);
+                radius = INFINITY;
+                return;
+            }
+            const Mat<4>& transform = primitives[pmt_i].local_transform;
+            for(u64 corner_i = 0; corner_i < 8; corner_i += 1) {
+                Vec<4> corner = Vec<4>(
+                    (corner_i & 1) == 0? bounds.min.x() : bounds.max.x(),
+                    (corner_i & 2) == 0? bounds.min.y() : bounds.max.y(),
+                    (corner_i & 4) == 0? bounds.min.z() : bounds.max.z(),
+                    1.0
+                );
+                Vec<3> pos = (transform * corner).swizzle<3>("xyz");
+                for(size_t axis = 0; axis < 3; axis += 1) {
+                    min[axis] = std::min(min[axis], pos[axis]);
+                    max[axis] = std::max(max[axis], pos[axis]);
+                }
+            }
+        }
+        if(primitives.size() == 0) {
+            center = Vec<3>(0, 0, 0);
+            radius = 0.0;
+            return;
+        }
+        center = (min + max) * 0.5;
+        radius = (max - min).len() * 0.5;
+    }
+
     Model Model::from_resource(const Model::LoadArgs& args) {
         std::string path = std::string(args.path);
         std::span<const std::pair<Attrib, Mesh::Attrib>> attribs 
@@ -672,7 +733,11 @@ namespace houseofatmos::engine {
         result.face_culling = args.face_culling;
         gltf_collect_textures(model, result.textures, path);
         std::unordered_map<u64, size_t> primitive_indices;
-        gltf_collect_primitives(model, result.primitives, primitive_indices, attribs, path);
+        std::vector<GltfBounds> primitive_bounds;
+        gltf_collect_primitives(
+            model, result.primitives, primitive_bounds, 
+            primitive_indices, attribs, path
+        );
         std::vector<std::unordered_map<size_t, u16>> node_to_joint;
         gltf_collect_skeletons(model, result.skeletons, node_to_joint, path);
         tinygltf::Scene& scene = model.scenes[model.defaultScene];
@@ -683,6 +748,10 @@ namespace houseofatmos::engine {
             path
         );
         gltf_collect_animations(model, result.animations, node_to_joint, path);
+        compute_model_bounds(
+            result.primitives, primitive_bounds, 
+            result.bounding_center, result.bounding_radius
+        );
         return result;
     }
 
@@ -708,11 +777,12 @@ namespace houseofatmos::engine {
 
     void Model::render_all(
         Shader& shader, RenderTarget dest,
-        std::optional<std::string_view> local_transform_uniform,
-        std::optional<std::string_view> texture_uniform,
-        std::optional<std::string_view> joint_transform_uniform,
+        std::optional<Shader::Uniform> local_transform_uniform,
+        std::optional<Shader::Uniform> texture_uniform,
+        std::optional<Shader::Uniform> joint_transform_uniform,
         size_t count, FaceCulling face_culling, 
-        DepthTesting depth_testing
+        DepthTesting depth_testing,
+        const InstanceBuffer* instances, size_t first_instance
     ) {
         FaceCulling allow_culling = this->face_culling == FaceCulling::Disabled
             ? FaceCulling::Disabled 
@@ -738,19 +808,34 @@ namespace houseofatmos::engine {
                 shader.set_uniform(*joint_transform_uniform, std::vector { Mat<4>() });
             }
             primitive.geometry.render(
-                shader, dest, count, allow_culling, depth_testing
+                shader, dest, count, allow_culling, depth_testing,
+                instances, first_instance
             );
         }
     }
 
-    void Model::render_all_animated(
+    std::vector<std::vector<Mat<4>>> Model::compute_poses(
+        const Animation& animation, f64 timestamp
+    ) const {
+        std::vector<std::vector<Mat<4>>> poses;
+        poses.reserve(this->skeletons.size());
+        for(const Animation::Skeleton& skeleton: this->skeletons) {
+            poses.push_back(
+                animation.compute_transformations(skeleton, timestamp)
+            );
+        }
+        return poses;
+    }
+
+    void Model::render_all_posed(
         Shader& shader, RenderTarget dest,
-        const Animation& animation, f64 timestamp,
-        std::string_view joint_transform_uniform,
-        std::optional<std::string_view> local_transform_uniform,
-        std::optional<std::string_view> texture_uniform,
+        std::span<const std::vector<Mat<4>>> poses,
+        const Shader::Uniform& joint_transform_uniform,
+        std::optional<Shader::Uniform> local_transform_uniform,
+        std::optional<Shader::Uniform> texture_uniform,
         size_t count, FaceCulling face_culling, 
-        DepthTesting depth_testing
+        DepthTesting depth_testing,
+        const InstanceBuffer* instances, size_t first_instance
     ) {
         FaceCulling allow_culling = this->face_culling == FaceCulling::Disabled
             ? FaceCulling::Disabled 
@@ -759,11 +844,9 @@ namespace houseofatmos::engine {
             (void) name;
             std::optional<size_t> skeleton_id = std::get<2>(mesh);
             if(skeleton_id.has_value()) {
-                const Animation::Skeleton& skeleton
-                    = this->skeletons.at(*skeleton_id);
                 shader.set_uniform(
                     joint_transform_uniform, 
-                    animation.compute_transformations(skeleton, timestamp)
+                    std::span<const Mat<4>>(poses[*skeleton_id])
                 );
             }
             Primitive& primitive = this->primitives.at(std::get<0>(mesh));
@@ -775,9 +858,30 @@ namespace houseofatmos::engine {
                 shader.set_uniform(*texture_uniform, texture);
             }
             primitive.geometry.render(
-                shader, dest, count, allow_culling, depth_testing
+                shader, dest, count, allow_culling, depth_testing,
+                instances, first_instance
             );
         }
     }
 
+    void Model::render_all_animated(
+        Shader& shader, RenderTarget dest,
+        const Animation& animation, f64 timestamp,
+        const Shader::Uniform& joint_transform_uniform,
+        std::optional<Shader::Uniform> local_transform_uniform,
+        std::optional<Shader::Uniform> texture_uniform,
+        size_t count, FaceCulling face_culling, 
+        DepthTesting depth_testing,
+        const InstanceBuffer* instances, size_t first_instance
+    ) {
+        std::vector<std::vector<Mat<4>>> poses
+            = this->compute_poses(animation, timestamp);
+        this->render_all_posed(
+            shader, dest, poses, joint_transform_uniform,
+            local_transform_uniform, texture_uniform,
+            count, face_culling, depth_testing,
+            instances, first_instance
+        );
+    }
+
 }
\ No newline at end of file
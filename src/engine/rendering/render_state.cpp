@@ -0,0 +1,121 @@
+
+#include <engine/rendering.hpp>
+#include <glad/gles2.h>
+
+namespace houseofatmos::engine {
+
+    // marks state that is not known, since it has not been set yet
+    static const u64 unknown = UINT64_MAX;
+
+    struct TextureUnit {
+        u64 texture_2d = 0;
+        u64 texture_2d_array = 0;
+    };
+
+    // state after the context has been created
+    static u64 framebuffer = 0;
+    static UVec<2> viewport = UVec<2>(unknown, unknown); // width and height
+    static u64 program = 0;
+    static u64 vertex_array = 0;
+    static u64 array_buffer = 0;
+    static u64 active_texture = 0;
+    static std::vector<TextureUnit> texture_units;
+    static bool face_culling = false;
+    static bool depth_testing = false;
+
+    static RenderState::Stats counters = { 0, 0 };
+
+    // returns true if the state needs to be changed
+    template<typename T>
+    static bool update(T& tracked, T value) {
+        if(tracked == value) {
+            counters.skipped += 1;
+            return false;
+        }
+        tracked = value;
+        counters.issued += 1;
+        return true;
+    }
+
+    void RenderState::bind_framebuffer(u64 fbo_id) {
+        if(!update(framebuffer, fbo_id)) { return; }
+        glBindFramebuffer(GL_FRAMEBUFFER, fbo_id);
+    }
+
+    void RenderState::set_viewport(u64 width, u64 height) {
+        if(!update(viewport, UVec<2>(width, height))) { return; }
+        glViewport(0, 0, width, height);
+    }
+
+    void RenderState::use_program(u64 prog_id) {
+        if(!update(program, prog_id)) { return; }
+        glUseProgram(prog_id);
+    }
+
+    void RenderState::bind_vertex_array(u64 vao_id) {
+        if(!update(vertex_array, vao_id)) { return; }
+        glBindVertexArray(vao_id);
+    }
+
+    void RenderState::bind_array_buffer(u64 vbo_id) {
+        if(!update(array_buffer, vbo_id)) { return; }
+        glBindBuffer(GL_ARRAY_BUFFER, vbo_id);
+    }
+
+    void RenderState::bind_texture(u64 slot, u64 tex_id, bool is_array) {
+        if(texture_units.size() <= slot) { texture_units.resize(slot + 1); }
+        TextureUnit& unit = texture_units[slot];
+        u64& bound = is_array? unit.texture_2d_array : unit.texture_2d;
+        if(!update(bound, tex_id)) { return; }
+        if(update(active_texture, slot)) {
+            glActiveTexture(GL_TEXTURE0 + slot);
+        }
+        glBindTexture(is_array? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D, tex_id);
+    }
+
+    void RenderState::set_face_culling(FaceCulling culling) {
+        bool enabled = culling == FaceCulling::Enabled;
+        if(!update(face_culling, enabled)) { return; }
+        if(enabled) { glEnable(GL_CULL_FACE); }
+        else { glDisable(GL_CULL_FACE); }
+    }
+
+    void RenderState::set_depth_testing(DepthTesting testing) {
+        bool enabled = testing == DepthTesting::Enabled;
+        if(!update(depth_testing, enabled)) { return; }
+        if(enabled) { glEnable(GL_DEPTH_TEST); }
+        else { glDisable(GL_DEPTH_TEST); }
+    }
+
+
+    void RenderState::deleted_framebuffer(u64 fbo_id) {
+        if(framebuffer == fbo_id) { framebuffer = 0; }
+    }
+
+    void RenderState::deleted_program(u64 prog_id) {
+        // unlike other objects programs stay in use after being deleted,
+        // but a new program could get the same ID
+        if(program == prog_id) { RenderState::use_program(0); }
+    }
+
+    void RenderState::deleted_vertex_array(u64 vao_id) {
+        if(vertex_array == vao_id) { vertex_array = 0; }
+    }
+
+    void RenderState::deleted_buffer(u64 buffer_id) {
+        if(array_buffer == buffer_id) { array_buffer = 0; }
+    }
+
+    void RenderState::deleted_texture(u64 tex_id) {
+        for(TextureUnit& unit: texture_units) {
+            if(unit.texture_2d == tex_id) { unit.texture_2d = 0; }
+            if(unit.texture_2d_array == tex_id) { unit.texture_2d_array = 0; }
+        }
+    }
+
+
+    const RenderState::Stats& RenderState::stats() { return counters; }
+
+    void RenderState::reset_stats() { counters = { 0, 0 }; }
+
+}
@@ -10,6 +10,7 @@ namespace fs = std::filesystem;
 namespace houseofatmos::engine {
 
     void Shader::destruct(const Handles& handles) {
+        RenderState::deleted_program(handles.prog_id);
         glDeleteShader(handles.vert_id);
         glDeleteShader(handles.frag_id);
         glDeleteProgram(handles.prog_id);
@@ -156,6 +157,34 @@ namespace houseofatmos::engine {
         this->handles = util::Handle<Handles, &Shader::destruct>(
             Handles(vert_id, frag_id, prog_id)
         );
+        this->collect_uniform_locations();
+    }
+
+    void Shader::collect_uniform_locations() {
+        GLuint program = this->handles->prog_id;
+        GLint uniform_count;
+        glGetProgramiv(program, GL_ACTIVE_UNIFORMS, &uniform_count);
+        GLint max_name_len;
+        glGetProgramiv(program, GL_ACTIVE_UNIFORM_MAX_LENGTH, &max_name_len);
+        auto name = std::string(max_name_len, '\0');
+        for(GLint uniform_i = 0; uniform_i < uniform_count; uniform_i += 1) {
+            GLsizei name_len;
+            GLint size;
+            GLenum type;
+            glGetActiveUniform(
+                program, uniform_i, max_name_len, 
+                &name_len, &size, &type, name.data()
+            );
+            auto uniform_name = std::string(name.data(), name_len);
+            GLint location = glGetUniformLocation(program, uniform_name.data());
+            if(location == -1) { continue; } // part of a uniform block
+            // arrays are reported as 'name[0]', but are set using 'name'
+            if(uniform_name.ends_with("[0]")) {
+                this->uniform_locations[uniform_name] = location;
+                uniform_name.resize(uniform_name.size() - 3);
+            }
+            this->uniform_locations[uniform_name] = location;
+        }
     }
 
     Shader Shader::from_resource(const Shader::LoadArgs& args) {
@@ -169,23 +198,13 @@ namespace houseofatmos::engine {
 
 
     void Shader::internal_bind() const {
-        glUseProgram(this->handles->prog_id);
+        RenderState::use_program(this->handles->prog_id);
         for(const auto& [tex_id, slot_info]: this->texture_slots) {
             const auto& [slot, is_array] = slot_info;
-            glActiveTexture(GL_TEXTURE0 + slot);
-            glBindTexture(is_array? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D, tex_id);
+            RenderState::bind_texture(slot, tex_id, is_array);
         }
     }
 
-    void Shader::internal_unbind() const {
-        for(const auto& [tex_id, slot_info]: this->texture_slots) {
-            const auto& [slot, is_array] = slot_info;
-            glActiveTexture(GL_TEXTURE0 + slot);
-            glBindTexture(is_array? GL_TEXTURE_2D_ARRAY : GL_TEXTURE_2D, 0);
-        }
-        glUseProgram(0);
-    }
-
 
     size_t Shader::max_textures() {
         GLint max_units;
@@ -194,29 +213,40 @@ namespace houseofatmos::engine {
     }
 
 
-    static GLint binded_uniform_loc(GLuint program, std::string_view name) {
-        GLint current_program;
-        glGetIntegerv(GL_CURRENT_PROGRAM, &current_program);
-        if(static_cast<GLuint>(current_program) != program) {
-            glUseProgram(program);
+    Shader::Uniform Shader::resolve_uniform(std::string_view name) {
+        auto cached = this->uniform_locations.find(name);
+        if(cached != this->uniform_locations.end()) {
+            return Uniform(cached->first, cached->second);
         }
+        // not collected after linking, for example single array elements
         auto name_nt = std::string(name);
-        GLint location = glGetUniformLocation(program, name_nt.data());
+        GLint location = glGetUniformLocation(
+            this->handles->prog_id, name_nt.data()
+        );
         if(location == -1) {
             error("The shader does not have any uniform with the name '"
-                + std::string(name) + "'"
+                + name_nt + "'"
             );
         }
-        return location;
+        auto [inserted, was_inserted] = this->uniform_locations
+            .emplace(std::move(name_nt), location);
+        (void) was_inserted;
+        return Uniform(inserted->first, inserted->second);
+    }
+
+    i64 Shader::binded_uniform_loc(const Uniform& uniform) {
+        RenderState::use_program(this->handles->prog_id);
+        if(uniform.location != -1) { return uniform.location; }
+        return this->resolve_uniform(uniform.name).location;
     }
 
     u64 Shader::allocate_texture_slot(
-        std::string name, u64 tex_id, bool is_array
+        i64 location, u64 tex_id, bool is_array
     ) {
         u64 max_slot_count = Shader::max_textures();
         // if this variable already had a texture, get rid of it
-        if(this->uniform_textures.contains(name)) {
-            u64 old_tex_id = this->uniform_textures.at(name);
+        if(this->uniform_textures.contains(location)) {
+            u64 old_tex_id = this->uniform_textures.at(location);
             u64 old_tex_count = this->texture_uniform_count.at(old_tex_id);
             old_tex_count -= 1;
             if(old_tex_count > 0) {
@@ -256,31 +286,25 @@ namespace houseofatmos::engine {
         // use the slot
         auto [rc, inserted] = texture_uniform_count.emplace(tex_id, 0);
         rc->second += 1;
-        this->uniform_textures[name] = tex_id;
+        this->uniform_textures[location] = tex_id;
         this->texture_slots[tex_id] = { slot, is_array };
         return slot;
     }
 
-    void Shader::set_uniform(std::string_view name_v, const Texture& texture) {
-        auto name = std::string(name_v);
+    void Shader::set_uniform(const Uniform& uniform, const Texture& texture) {
+        GLint location = this->binded_uniform_loc(uniform);
         u64 tex_id = texture.internal_tex_id();
-        u64 slot = this->allocate_texture_slot(name, tex_id, false /* not tex array */);
-        GLint location = binded_uniform_loc(this->handles->prog_id, name);
-        glActiveTexture(GL_TEXTURE0 + slot);
-        glBindTexture(GL_TEXTURE_2D, tex_id);
+        u64 slot = this->allocate_texture_slot(location, tex_id, false /* not tex array */);
         glUniform1i(location, slot);
     }
 
     void Shader::set_uniform(
-        std::string_view name_v, const TextureArray& textures
+        const Uniform& uniform, const TextureArray& textures
     ) {
         if(textures.size() == 0) { return; }
-        auto name = std::string(name_v);
+        GLint location = this->binded_uniform_loc(uniform);
         u64 tex_id = textures.internal_tex_id();
-        u64 slot = this->allocate_texture_slot(name, tex_id, true /* is tex array */);
-        GLint location = binded_uniform_loc(this->handles->prog_id, name);
-        glActiveTexture(GL_TEXTURE0 + slot);
-        glBindTexture(GL_TEXTURE_2D_ARRAY, tex_id);
+        u64 slot = this->allocate_texture_slot(location, tex_id, true /* is tex array */);
         glUniform1i(location, slot);
     }
 
@@ -307,141 +331,141 @@ namespace houseofatmos::engine {
         return result;
     }
 
-    void Shader::set_uniform(std::string_view name, f64 v) {
+    void Shader::set_uniform(const Uniform& uniform, f64 v) {
         glUniform1f(
-            binded_uniform_loc(this->handles->prog_id, name), v
+            this->binded_uniform_loc(uniform), v
         );
     }
-    void Shader::set_uniform(std::string_view name, Vec<2> v) {
+    void Shader::set_uniform(const Uniform& uniform, Vec<2> v) {
         glUniform2f(
-            binded_uniform_loc(this->handles->prog_id, name), v.x(), v.y()
+            this->binded_uniform_loc(uniform), v.x(), v.y()
         );
     }
-    void Shader::set_uniform(std::string_view name, Vec<3> v) {
+    void Shader::set_uniform(const Uniform& uniform, Vec<3> v) {
         glUniform3f(
-            binded_uniform_loc(this->handles->prog_id, name), 
+            this->binded_uniform_loc(uniform), 
             v.x(), v.y(), v.z()
         );
     }
-    void Shader::set_uniform(std::string_view name, Vec<4> v) {
+    void Shader::set_uniform(const Uniform& uniform, Vec<4> v) {
         glUniform4f(
-            binded_uniform_loc(this->handles->prog_id, name), 
+            this->binded_uniform_loc(uniform), 
             v.x(), v.y(), v.z(), v.w()
         );
     }
-    void Shader::set_uniform(std::string_view name, std::span<const f64> value) {
+    void Shader::set_uniform(const Uniform& uniform, std::span<const f64> value) {
         glUniform1fv(
-            binded_uniform_loc(this->handles->prog_id, name), value.size(),
+            this->binded_uniform_loc(uniform), value.size(),
             cast_array<f64, GLfloat>(value).data()
         );
     }
-    void Shader::set_uniform(std::string_view name, std::span<const Vec<2>> value) {
+    void Shader::set_uniform(const Uniform& uniform, std::span<const Vec<2>> value) {
         glUniform2fv(
-            binded_uniform_loc(this->handles->prog_id, name), value.size(),
+            this->binded_uniform_loc(uniform), value.size(),
             flatten_array<2, f64, GLfloat>(value).data()
         );
     }
-    void Shader::set_uniform(std::string_view name, std::span<const Vec<3>> value) {
+    void Shader::set_uniform(const Uniform& uniform, std::span<const Vec<3>> value) {
         glUniform3fv(
-            binded_uniform_loc(this->handles->prog_id, name), value.size(),
+            this->binded_uniform_loc(uniform), value.size(),
             flatten_array<3, f64, GLfloat>(value).data()
         );
     }
-    void Shader::set_uniform(std::string_view name, std::span<const Vec<4>> value) {
+    void Shader::set_uniform(const Uniform& uniform, std::span<const Vec<4>> value) {
         glUniform4fv(
-            binded_uniform_loc(this->handles->prog_id, name), value.size(),
+            this->binded_uniform_loc(uniform), value.size(),
             flatten_array<4, f64, GLfloat>(value).data()
         );
     }
 
 
-    void Shader::set_uniform(std::string_view name, i64 v) {
-        glUniform1i(binded_uniform_loc(this->handles->prog_id, name), v);
+    void Shader::set_uniform(const Uniform& uniform, i64 v) {
+        glUniform1i(this->binded_uniform_loc(uniform), v);
     }
-    void Shader::set_uniform(std::string_view name, IVec<2> v) {
+    void Shader::set_uniform(const Uniform& uniform, IVec<2> v) {
         glUniform2i(
-            binded_uniform_loc(this->handles->prog_id, name), v.x(), v.y()
+            this->binded_uniform_loc(uniform), v.x(), v.y()
         );
     }
-    void Shader::set_uniform(std::string_view name, IVec<3> v) {
+    void Shader::set_uniform(const Uniform& uniform, IVec<3> v) {
         glUniform3i(
-            binded_uniform_loc(this->handles->prog_id, name), 
+            this->binded_uniform_loc(uniform), 
             v.x(), v.y(), v.z()
         );
     }
-    void Shader::set_uniform(std::string_view name, IVec<4> v) {
+    void Shader::set_uniform(const Uniform& uniform, IVec<4> v) {
         glUniform4i(
-            binded_uniform_loc(this->handles->prog_id, name), 
+            this->binded_uniform_loc(uniform), 
             v.x(), v.y(), v.z(), v.w()
         );
     }
-    void Shader::set_uniform(std::string_view name, std::span<const i64> value) {
+    void Shader::set_uniform(const Uniform& uniform, std::span<const i64> value) {
         glUniform1iv(
-            binded_uniform_loc(this->handles->prog_id, name), value.size(),
+            this->binded_uniform_loc(uniform), value.size(),
             cast_array<i64, GLint>(value).data()
         );
     }
-    void Shader::set_uniform(std::string_view name, std::span<const IVec<2>> value) {
+    void Shader::set_uniform(const Uniform& uniform, std::span<const IVec<2>> value) {
         glUniform2iv(
-            binded_uniform_loc(this->handles->prog_id, name), value.size(),
+            this->binded_uniform_loc(uniform), value.size(),
             flatten_array<2, i64, GLint>(value).data()
         );
     }
-    void Shader::set_uniform(std::string_view name, std::span<const IVec<3>> value) {
+    void Shader::set_uniform(const Uniform& uniform, std::span<const IVec<3>> value) {
         glUniform3iv(
-            binded_uniform_loc(this->handles->prog_id, name), value.size(),
+            this->binded_uniform_loc(uniform), value.size(),
             flatten_array<3, i64, GLint>(value).data()
         );
     }
-    void Shader::set_uniform(std::string_view name, std::span<const IVec<4>> value) {
+    void Shader::set_uniform(const Uniform& uniform, std::span<const IVec<4>> value) {
         glUniform4iv(
-            binded_uniform_loc(this->handles->prog_id, name), value.size(),
+            this->binded_uniform_loc(uniform), value.size(),
             flatten_array<4, i64, GLint>(value).data()
         );
     }
 
 
-    void Shader::set_uniform(std::string_view name, u64 v) {
-        glUniform1i(binded_uniform_loc(this->handles->prog_id, name), v);
+    void Shader::set_uniform(const Uniform& uniform, u64 v) {
+        glUniform1i(this->binded_uniform_loc(uniform), v);
     }
-    void Shader::set_uniform(std::string_view name, UVec<2> v) {
+    void Shader::set_uniform(const Uniform& uniform, UVec<2> v) {
         glUniform2i(
-            binded_uniform_loc(this->handles->prog_id, name), v.x(), v.y()
+            this->binded_uniform_loc(uniform), v.x(), v.y()
         );
     }
-    void Shader::set_uniform(std::string_view name, UVec<3> v) {
+    void Shader::set_uniform(const Uniform& uniform, UVec<3> v) {
         glUniform3i(
-            binded_uniform_loc(this->handles->prog_id, name), 
+            this->binded_uniform_loc(uniform), 
             v.x(), v.y(), v.z()
         );
     }
-    void Shader::set_uniform(std::string_view name, UVec<4> v) {
+    void Shader::set_uniform(const Uniform& uniform, UVec<4> v) {
         glUniform4i(
-            binded_uniform_loc(this->handles->prog_id, name),
+            this->binded_uniform_loc(uniform),
             v.x(), v.y(), v.z(), v.w()
         );
     }
-    void Shader::set_uniform(std::string_view name, std::span<const u64> value) {
+    void Shader::set_uniform(const Uniform& uniform, std::span<const u64> value) {
         glUniform1uiv(
-            binded_uniform_loc(this->handles->prog_id, name), value.size(),
+            this->binded_uniform_loc(uniform), value.size(),
             cast_array<u64, GLuint>(value).data()
         );
     }
-    void Shader::set_uniform(std::string_view name, std::span<const UVec<2>> value) {
+    void Shader::set_uniform(const Uniform& uniform, std::span<const UVec<2>> value) {
         glUniform2uiv(
-            binded_uniform_loc(this->handles->prog_id, name), value.size(),
+            this->binded_uniform_loc(uniform), value.size(),
             flatten_array<2, u64, GLuint>(value).data()
         );
     }
-    void Shader::set_uniform(std::string_view name, std::span<const UVec<3>> value) {
+    void Shader::set_uniform(const Uniform& uniform, std::span<const UVec<3>> value) {
         glUniform3uiv(
-            binded_uniform_loc(this->handles->prog_id, name), value.size(),
+            this->binded_uniform_loc(uniform), value.size(),
             flatten_array<3, u64, GLuint>(value).data()
         );
     }
-    void Shader::set_uniform(std::string_view name, std::span<const UVec<4>> value) {
+    void Shader::set_uniform(const Uniform& uniform, std::span<const UVec<4>> value) {
         glUniform4uiv(
-            binded_uniform_loc(this->handles->prog_id, name), value.size(),
+            this->binded_uniform_loc(uniform), value.size(),
             flatten_array<4, u64, GLuint>(value).data()
         );
     }
@@ -461,120 +485,120 @@ namespace houseofatmos::engine {
         return result;
     }
 
-    void Shader::set_uniform(std::string_view name, const Mat<2>& value) {
+    void Shader::set_uniform(const Uniform& uniform, const Mat<2>& value) {
         glUniformMatrix2fv(
-            binded_uniform_loc(this->handles->prog_id, name), 1, GL_FALSE,
+            this->binded_uniform_loc(uniform), 1, GL_FALSE,
             flatten_matrices<2, 2>(&value, 1).data()
         );
     }
-    void Shader::set_uniform(std::string_view name, const Mat<3>& value) {
+    void Shader::set_uniform(const Uniform& uniform, const Mat<3>& value) {
         glUniformMatrix3fv(
-            binded_uniform_loc(this->handles->prog_id, name), 1, GL_FALSE,
+            this->binded_uniform_loc(uniform), 1, GL_FALSE,
             flatten_matrices<3, 3>(&value, 1).data()
         );
     }
-    void Shader::set_uniform(std::string_view name, const Mat<4>& value) {
+    void Shader::set_uniform(const Uniform& uniform, const Mat<4>& value) {
         glUniformMatrix4fv(
-            binded_uniform_loc(this->handles->prog_id, name), 1, GL_FALSE,
+            this->binded_uniform_loc(uniform), 1, GL_FALSE,
             flatten_matrices<4, 4>(&value, 1).data()
         );
     }
-    void Shader::set_uniform(std::string_view name, const Mat<2, 3>& value) {
+    void Shader::set_uniform(const Uniform& uniform, const Mat<2, 3>& value) {
         glUniformMatrix3x2fv(
-            binded_uniform_loc(this->handles->prog_id, name), 1, GL_FALSE,
+            this->binded_uniform_loc(uniform), 1, GL_FALSE,
             flatten_matrices<2, 3>(&value, 1).data()
         );
     }
-    void Shader::set_uniform(std::string_view name, const Mat<3, 2>& value) {
+    void Shader::set_uniform(const Uniform& uniform, const Mat<3, 2>& value) {
         glUniformMatrix2x3fv(
-            binded_uniform_loc(this->handles->prog_id, name), 1, GL_FALSE,
+            this->binded_uniform_loc(uniform), 1, GL_FALSE,
             flatten_matrices<3, 2>(&value, 1).data()
         );
     }
-    void Shader::set_uniform(std::string_view name, const Mat<2, 4>& value) {
+    void Shader::set_uniform(const Uniform& uniform, const Mat<2, 4>& value) {
         glUniformMatrix4x2fv(
-            binded_uniform_loc(this->handles->prog_id, name), 1, GL_FALSE,
+            this->binded_uniform_loc(uniform), 1, GL_FALSE,
             flatten_matrices<2, 4>(&value, 1).data()
         );
     }
-    void Shader::set_uniform(std::string_view name, const Mat<4, 2>& value) {
+    void Shader::set_uniform(const Uniform& uniform, const Mat<4, 2>& value) {
         glUniformMatrix2x4fv(
-            binded_uniform_loc(this->handles->prog_id, name), 1, GL_FALSE,
+            this->binded_uniform_loc(uniform), 1, GL_FALSE,
             flatten_matrices<4, 2>(&value, 1).data()
         );
     }
-    void Shader::set_uniform(std::string_view name, const Mat<3, 4>& value) {
+    void Shader::set_uniform(const Uniform& uniform, const Mat<3, 4>& value) {
         glUniformMatrix4x3fv(
-            binded_uniform_loc(this->handles->prog_id, name), 1, GL_FALSE,
+            this->binded_uniform_loc(uniform), 1, GL_FALSE,
             flatten_matrices<3, 4>(&value, 1).data()
         );
     }
-    void Shader::set_uniform(std::string_view name, const Mat<4, 3>& value) {
+    void Shader::set_uniform(const Uniform& uniform, const Mat<4, 3>& value) {
         glUniformMatrix3x4fv(
-            binded_uniform_loc(this->handles->prog_id, name), 1, GL_FALSE,
+            this->binded_uniform_loc(uniform), 1, GL_FALSE,
             flatten_matrices<4, 3>(&value, 1).data()
         );
     }
 
-    void Shader::set_uniform(std::string_view name, std::span<const Mat<2>> value) {
+    void Shader::set_uniform(const Uniform& uniform, std::span<const Mat<2>> value) {
         glUniformMatrix2fv(
-            binded_uniform_loc(this->handles->prog_id, name), 
+            this->binded_uniform_loc(uniform), 
             value.size(), GL_FALSE,
             flatten_matrices<2, 2>(value.data(), value.size()).data()
         );
     }
-    void Shader::set_uniform(std::string_view name, std::span<const Mat<3>> value) {
+    void Shader::set_uniform(const Uniform& uniform, std::span<const Mat<3>> value) {
         glUniformMatrix3fv(
-            binded_uniform_loc(this->handles->prog_id, name), 
+            this->binded_uniform_loc(uniform), 
             value.size(), GL_FALSE,
             flatten_matrices<3, 3>(value.data(), value.size()).data()
         );
     }
-    void Shader::set_uniform(std::string_view name, std::span<const Mat<4>> value) {
+    void Shader::set_uniform(const Uniform& uniform, std::span<const Mat<4>> value) {
         glUniformMatrix4fv(
-            binded_uniform_loc(this->handles->prog_id, name), 
+            this->binded_uniform_loc(uniform), 
             value.size(), GL_FALSE,
             flatten_matrices<4, 4>(value.data(), value.size()).data()
         );
     }
-    void Shader::set_uniform(std::string_view name, std::span<const Mat<2, 3>> value) {
+    void Shader::set_uniform(const Uniform& uniform, std::span<const Mat<2, 3>> value) {
         glUniformMatrix3x2fv(
-            binded_uniform_loc(this->handles->prog_id, name), 
+            this->binded_uniform_loc(uniform), 
             value.size(), GL_FALSE,
             flatten_matrices<2, 3>(value.data(), value.size()).data()
         );
     }
-    void Shader::set_uniform(std::string_view name, std::span<const Mat<3, 2>> value) {
+    void Shader::set_uniform(const Uniform& uniform, std::span<const Mat<3, 2>> value) {
         glUniformMatrix2x3fv(
-            binded_uniform_loc(this->handles->prog_id, name), 
+            this->binded_uniform_loc(uniform), 
             value.size(), GL_FALSE,
             flatten_matrices<3, 2>(value.data(), value.size()).data()
         );
     }
-    void Shader::set_uniform(std::string_view name, std::span<const Mat<2, 4>> value) {
+    void Shader::set_uniform(const Uniform& uniform, std::span<const Mat<2, 4>> value) {
         glUniformMatrix4x2fv(
-            binded_uniform_loc(this->handles->prog_id, name),
+            this->binded_uniform_loc(uniform),
             value.size(), GL_FALSE,
             flatten_matrices<2, 4>(value.data(), value.size()).data()
         );
     }
-    void Shader::set_uniform(std::string_view name, std::span<const Mat<4, 2>> value) {
+    void Shader::set_uniform(const Uniform& uniform, std::span<const Mat<4, 2>> value) {
         glUniformMatrix2x4fv(
-            binded_uniform_loc(this->handles->prog_id, name),
+            this->binded_uniform_loc(uniform),
             value.size(), GL_FALSE,
             flatten_matrices<4, 2>(value.data(), value.size()).data()
         );
     }
-    void Shader::set_uniform(std::string_view name, std::span<const Mat<3, 4>> value) {
+    void Shader::set_uniform(const Uniform& uniform, std::span<const Mat<3, 4>> value) {
         glUniformMatrix4x3fv(
-            binded_uniform_loc(this->handles->prog_id, name),
+            this->binded_uniform_loc(uniform),
             value.size(), GL_FALSE,
             flatten_matrices<3, 4>(value.data(), value.size()).data()
         );
     }
-    void Shader::set_uniform(std::string_view name, std::span<const Mat<4, 3>> value) {
+    void Shader::set_uniform(const Uniform& uniform, std::span<const Mat<4, 3>> value) {
         glUniformMatrix3x4fv(
-            binded_uniform_loc(this->handles->prog_id, name),
+            this->binded_uniform_loc(uniform),
             value.size(), GL_FALSE,
             flatten_matrices<4, 3>(value.data(), value.size()).data()
         );
@@ -8,11 +8,13 @@
 namespace houseofatmos::engine {
 
     void Texture::destruct_tex(const u64& tex_id) {
+        RenderState::deleted_texture(tex_id);
         GLuint tex_gl_id = tex_id;
         glDeleteTextures(1, &tex_gl_id);
     }
 
     void Texture::destruct_fbo(const FboHandles& fbo) {
+        RenderState::deleted_framebuffer(fbo.fbo_id);
         GLuint fbo_id = fbo.fbo_id;
         glDeleteFramebuffers(1, &fbo_id);
         GLuint dbo_id = fbo.dbo_id;
@@ -22,14 +24,14 @@ namespace houseofatmos::engine {
     static GLuint init_fbo() {
         GLuint fbo_id;
         glGenFramebuffers(1, &fbo_id);
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo_id);
+        RenderState::bind_framebuffer(fbo_id);
         return fbo_id;
     }
 
     static GLuint init_tex(u64 width, u64 height, const void* data) {
         GLuint tex_id;
         glGenTextures(1, &tex_id);
-        glBindTexture(GL_TEXTURE_2D, tex_id);
+        RenderState::bind_texture(0, tex_id, false);
         glTexImage2D(
             GL_TEXTURE_2D, 0, GL_RGBA, 
             width, height, 0, GL_RGBA, 
@@ -106,8 +108,6 @@ namespace houseofatmos::engine {
                 " GPU capabilities may be insufficient."
             );
         }
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
-        glBindTexture(GL_TEXTURE_2D, 0);
         this->fbo = util::Handle<FboHandles, &Texture::destruct_fbo>(
             FboHandles(fbo_id, dbo_id)
         );
@@ -6,11 +6,13 @@ namespace houseofatmos::engine {
 
     void TextureArray::destruct(const Handles& handles) {
         for(size_t layer_i = 0; layer_i < handles.layers.size(); layer_i += 1) {
+            RenderState::deleted_framebuffer(handles.layers[layer_i].fbo_id);
             GLuint fbo_id = handles.layers[layer_i].fbo_id;
             glDeleteFramebuffers(1, &fbo_id);
             GLuint dbo_id = handles.layers[layer_i].dbo_id;
             glDeleteRenderbuffers(1, &dbo_id);
         }
+        RenderState::deleted_texture(handles.tex_id);
         GLuint tex_id = handles.tex_id;
         glDeleteTextures(1, &tex_id);
     }
@@ -21,7 +23,7 @@ namespace houseofatmos::engine {
     ) {
         GLuint array_id;
         glGenTextures(1, &array_id);
-        glBindTexture(GL_TEXTURE_2D_ARRAY, array_id);
+        RenderState::bind_texture(0, array_id, true);
         glTexImage3D(
             GL_TEXTURE_2D_ARRAY, 0, GL_RGBA,
             width, height, layers, 
@@ -41,13 +43,12 @@ namespace houseofatmos::engine {
                     " (while creating a 'TextureArray')"
                 );
             }
-            glBindFramebuffer(GL_FRAMEBUFFER, texture.internal_fbo_id());
+            RenderState::bind_framebuffer(texture.internal_fbo_id());
             glCopyTexSubImage3D(
                 GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer_i, 
                 0, 0, texture.width(), texture.height()
             );
         }
-        glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
         return array_id;
     }
 
@@ -56,7 +57,7 @@ namespace houseofatmos::engine {
     ) {
         GLuint fbo_id;
         glGenFramebuffers(1, &fbo_id);
-        glBindFramebuffer(GL_FRAMEBUFFER, fbo_id);
+        RenderState::bind_framebuffer(fbo_id);
         glFramebufferTextureLayer(
             GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, array_id, 0, layer_i
         );
@@ -79,7 +80,6 @@ namespace houseofatmos::engine {
                 + " GPU capabilities may be insufficient."
             );
         }
-        glBindFramebuffer(GL_FRAMEBUFFER, 0);
         return { fbo_id, dbo_id };
     }
 
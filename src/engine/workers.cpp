@@ -0,0 +1,81 @@
+#include <engine/workers.hpp>
+#include <algorithm>
+
+namespace houseofatmos::engine {
+
+    static const size_t max_default_workers = 4;
+
+    size_t WorkerPool::default_worker_count() {
+        size_t hardware = (size_t) std::thread::hardware_concurrency();
+        // leave one thread for the main loop
+        size_t available = hardware > 1? hardware - 1 : 1;
+        return std::min(available, max_default_workers);
+    }
+
+    WorkerPool& WorkerPool::shared() {
+        static WorkerPool pool;
+        return pool;
+    }
+
+
+    #ifdef __EMSCRIPTEN__
+
+        WorkerPool::WorkerPool(size_t worker_count) {
+            (void) worker_count;
+        }
+
+        WorkerPool::~WorkerPool() {}
+
+        void WorkerPool::submit(Task&& task) {
+            task();
+        }
+
+    #else
+
+        WorkerPool::WorkerPool(size_t worker_count) {
+            worker_count = std::max(worker_count, (size_t) 1);
+            for(size_t w = 0; w < worker_count; w += 1) {
+                this->workers.push_back(std::thread([this]() {
+                    this->run_worker();
+                }));
+            }
+        }
+
+        WorkerPool::~WorkerPool() {
+            {
+                std::lock_guard<std::mutex> lock(this->tasks_lock);
+                this->stopping = true;
+            }
+            this->tasks_changed.notify_all();
+            for(std::thread& worker: this->workers) {
+                worker.join();
+            }
+        }
+
+        void WorkerPool::submit(Task&& task) {
+            {
+                std::lock_guard<std::mutex> lock(this->tasks_lock);
+                this->tasks.push_back(std::move(task));
+            }
+            this->tasks_changed.notify_one();
+        }
+
+        void WorkerPool::run_worker() {
+            for(;;) {
+                Task task;
+                {
+                    std::unique_lock<std::mutex> lock(this->tasks_lock);
+                    this->tasks_changed.wait(lock, [this]() {
+                        return this->stopping || !this->tasks.empty();
+                    });
+                    if(this->stopping) { return; }
+                    task = std::move(this->tasks.front());
+                    this->tasks.pop_front();
+                }
+                task();
+            }
+        }
+
+    #endif
+
+}
@@ -70,6 +70,7 @@ namespace houseofatmos::interior {
         Renderer& renderer, const Interior& interior, const Settings& settings
     ) {
         renderer.resolution = settings.resolution();
+        renderer.log_frame_stats = settings.log_render_stats;
         renderer.fog_color = background;
         renderer.shadow_depth_bias = interior.shadow_depth_bias;
         renderer.shadow_normal_offset = interior.shadow_normal_offset;
@@ -439,10 +439,13 @@ namespace houseofatmos {
             this->renderer.camera.look_at, 
             MainMenu::draw_distance_ch, nullptr, window, nullptr
         );
-        this->renderer.render_to_shadow_maps();
+        this->renderer.begin_recording();
         this->terrain.render_loaded_chunks(*this, this->renderer, window);
+        this->renderer.end_recording();
+        this->renderer.render_to_shadow_maps();
+        this->renderer.replay();
         this->renderer.render_to_output();
-        this->terrain.render_loaded_chunks(*this, this->renderer, window);
+        this->renderer.replay();
         this->terrain.render_water(*this, this->renderer, window);
         this->background.resize_fast(
             this->renderer.output().width(), this->renderer.output().height()
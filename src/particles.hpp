@@ -41,8 +41,14 @@ namespace houseofatmos {
             "res/shaders/particle_vert.glsl", "res/shaders/particle_frag.glsl"
         };
 
+        static const inline engine::Shader::LoadArgs inst_shader_args = {
+            "res/shaders/particle_inst_vert.glsl", 
+            "res/shaders/particle_frag.glsl"
+        };
+
         static void load_shaders(engine::Scene& scene) {
             scene.load(ParticleManager::shader_args);
+            scene.load(ParticleManager::inst_shader_args);
         }
 
         static const inline size_t max_inst_c = 128;
@@ -55,6 +61,12 @@ namespace houseofatmos {
             particles;
         std::vector<Vec<3>> positions;
         std::vector<Vec<2>> sizes;
+        // center position and size of each particle
+        engine::InstanceBuffer instances = engine::InstanceBuffer {
+            engine::Mesh::Attrib(engine::Mesh::F32, 3),
+            engine::Mesh::Attrib(engine::Mesh::F32, 2)
+        };
+        std::vector<f32> instance_data;
 
         public:
         ParticleManager() {
@@ -108,13 +120,36 @@ namespace houseofatmos {
             }
         } 
 
+        size_t upload_instances() {
+            this->instance_data.clear();
+            this->instance_data.reserve(this->positions.size() * 5);
+            for(size_t i = 0; i < this->positions.size(); i += 1) {
+                const Vec<3>& pos = this->positions[i];
+                const Vec<2>& size = this->sizes[i];
+                this->instance_data.insert(this->instance_data.end(), {
+                    (f32) pos.x(), (f32) pos.y(), (f32) pos.z(),
+                    (f32) size.x(), (f32) size.y()
+                });
+            }
+            return this->instances.upload(std::span(
+                (const u8*) this->instance_data.data(), 
+                this->instance_data.size() * sizeof(f32)
+            ));
+        }
+
         public:
         void render(
             Renderer& renderer, 
             engine::Scene& scene, const engine::Window& window,
             engine::DepthTesting depth_testing = engine::DepthTesting::Enabled
         ) {
-            engine::Shader& shader = scene.get(ParticleManager::shader_args);
+            // positions and sizes are passed as instance attributes if the
+            // renderer does so, and as uniform arrays otherwise
+            bool instanced = renderer.instance_buffers;
+            engine::Shader& shader = scene.get(instanced
+                ? ParticleManager::inst_shader_args 
+                : ParticleManager::shader_args
+            );
             shader.set_uniform("u_view_proj", renderer.compute_view_proj());
             Camera& cam = renderer.camera;
             Vec<3> cam_forward = (cam.position - cam.look_at).normalized();
@@ -141,6 +176,17 @@ namespace houseofatmos {
                     tex_size.y() - type->offset_tex.y() - type->size_tex.y()
                 ) / tex_size.y();
                 shader.set_uniform("u_uv_offset", Vec<2>(uv_o_u, uv_o_v));
+                if(instanced) {
+                    if(this->positions.size() == 0) { continue; }
+                    size_t first = this->upload_instances();
+                    this->billboard.render(
+                        shader, renderer.output().as_target(), 
+                        this->positions.size(),
+                        engine::FaceCulling::Disabled, depth_testing,
+                        &this->instances, first
+                    );
+                    continue;
+                }
                 std::span<const Vec<3>> pos = this->positions;
                 std::span<const Vec<2>> size = this->sizes;
                 for(size_t o = 0; o < this->positions.size();) {
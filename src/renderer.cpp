@@ -3,6 +3,37 @@
 
 namespace houseofatmos {
 
+    Frustum Frustum::from_view_proj(const Mat<4>& view_proj) {
+        // planes can be read directly from the rows of the view projection
+        // (Gribb and Hartmann, "Fast Extraction of Viewing Frustum Planes")
+        Vec<4> rows[4];
+        for(size_t row_i = 0; row_i < 4; row_i += 1) {
+            for(size_t column_i = 0; column_i < 4; column_i += 1) {
+                rows[row_i][column_i] = view_proj.element(row_i, column_i);
+            }
+        }
+        Frustum frustum;
+        for(size_t axis = 0; axis < 3; axis += 1) {
+            frustum.planes[axis * 2 + 0] = rows[3] + rows[axis];
+            frustum.planes[axis * 2 + 1] = rows[3] - rows[axis];
+        }
+        for(Vec<4>& plane: frustum.planes) {
+            f64 normal_len = plane.swizzle<3>("xyz").len();
+            if(normal_len == 0.0) { continue; }
+            plane = plane * (1.0 / normal_len);
+        }
+        return frustum;
+    }
+
+    bool Frustum::contains_sphere(const Vec<3>& center, f64 radius) const {
+        for(const Vec<4>& plane: this->planes) {
+            f64 dist = plane.swizzle<3>("xyz").dot(center) + plane.w();
+            if(dist < -radius) { return false; }
+        }
+        return true;
+    }
+
+
     static void resize_output_texture(
         engine::Texture& output, 
         const engine::Window& window,
@@ -26,6 +57,23 @@ namespace houseofatmos {
         output.clear_depth(1.0);
     }
 
+    void GeometryUniforms::resolve(
+        engine::Shader& shader, bool instance_attribs
+    ) {
+        this->view_proj = shader.resolve_uniform(this->view_proj.name);
+        this->local_transf = shader.resolve_uniform(this->local_transf.name);
+        this->joint_transfs = shader.resolve_uniform(this->joint_transfs.name);
+        this->texture = shader.resolve_uniform(this->texture.name);
+        if(instance_attribs) { return; }
+        this->model_transfs = shader.resolve_uniform(this->model_transfs.name);
+    }
+
+    void TerrainUniforms::resolve(engine::Shader& shader) {
+        this->view_proj = shader.resolve_uniform(this->view_proj.name);
+        this->model_transf = shader.resolve_uniform(this->model_transf.name);
+        this->texture = shader.resolve_uniform(this->texture.name);
+    }
+
     Mat<4> Renderer::compute_view_matrix() const {
         return Mat<4>::look_at(
             this->camera.position, this->camera.look_at, this->camera.up
@@ -47,14 +95,43 @@ namespace houseofatmos {
     void Renderer::configure(
         const engine::Window& window, engine::Scene& scene
     ) {
+        if(this->log_frame_stats) {
+            const engine::RenderState::Stats& state = this->state_stats();
+            engine::debug("Frame drew "
+                + std::to_string(this->culling.drawn) + " objects (culled "
+                + std::to_string(this->culling.culled) + "), changed GL state "
+                + std::to_string(state.issued) + " times (skipped "
+                + std::to_string(state.skipped) + ")"
+            );
+        }
+        this->culling = { 0, 0 };
+        engine::RenderState::reset_stats();
         resize_output_texture(this->target, window, this->resolution);
         clear_output_texture(this->target.as_target(), this->fog_color);
         this->shadow_shader = &scene.get(Renderer::shadow_shader_args);
         this->geometry_shader = &scene.get(Renderer::geometry_shader_args);
-        this->set_fog_uniforms(*this->geometry_shader);
-        this->set_diffuse_uniforms(*this->geometry_shader);
+        this->terrain_shadow_shader
+            = &scene.get(Renderer::terrain_shadow_shader_args);
+        this->terrain_shader = &scene.get(Renderer::terrain_shader_args);
+        this->shadow_inst_shader = &scene.get(Renderer::shadow_inst_shader_args);
+        this->geometry_inst_shader 
+            = &scene.get(Renderer::geometry_inst_shader_args);
+        this->shadow_uniforms.resolve(*this->shadow_shader, false);
+        this->geometry_uniforms.resolve(*this->geometry_shader, false);
+        this->shadow_inst_uniforms.resolve(*this->shadow_inst_shader, true);
+        this->geometry_inst_uniforms.resolve(*this->geometry_inst_shader, true);
+        this->terrain_shadow_uniforms.resolve(*this->terrain_shadow_shader);
+        this->terrain_uniforms.resolve(*this->terrain_shader);
         const engine::Texture& dither_pat = scene.get(Renderer::dither_pattern);
-        this->geometry_shader->set_uniform("u_dither_pattern", dither_pat);
+        auto shaded = { 
+            this->geometry_shader, this->geometry_inst_shader, 
+            this->terrain_shader 
+        };
+        for(engine::Shader* shader: shaded) {
+            this->set_fog_uniforms(*shader);
+            this->set_diffuse_uniforms(*shader);
+            shader->set_uniform("u_dither_pattern", dither_pat);
+        }
     }
 
     std::vector<Mat<4>> Renderer::collect_light_view_proj() const {
@@ -111,17 +188,98 @@ namespace houseofatmos {
                 this->lights.size()
             );
         }
+        this->light_frustums.clear();
         for(size_t light_i = 0; light_i < this->lights.size(); light_i += 1) {
             clear_output_texture(
                 this->shadow_maps.as_target(light_i),
                 { 1.0, 1.0, 1.0, 1.0 }
             );
+            this->light_frustums.push_back(Frustum::from_view_proj(
+                this->lights[light_i].compute_view_proj()
+            ));
         }
     }
 
     void Renderer::render_to_output() {
         this->rendering_shadow_maps = false;
+        this->camera_frustum = Frustum::from_view_proj(this->compute_view_proj());
         this->set_shadow_uniforms(*this->geometry_shader);
+        this->set_shadow_uniforms(*this->geometry_inst_shader);
+        this->set_shadow_uniforms(*this->terrain_shader);
+    }
+
+    size_t Renderer::upload_instances(std::span<const Mat<4>> model_transforms) {
+        this->instance_data.clear();
+        this->instance_data.reserve(model_transforms.size() * 16);
+        for(const Mat<4>& transform: model_transforms) {
+            for(size_t column_i = 0; column_i < 4; column_i += 1) {
+                for(size_t row_i = 0; row_i < 4; row_i += 1) {
+                    this->instance_data.push_back(
+                        (f32) transform.element(row_i, column_i)
+                    );
+                }
+            }
+        }
+        return this->instances.upload(std::span(
+            (const u8*) this->instance_data.data(), 
+            this->instance_data.size() * sizeof(f32)
+        ));
+    }
+
+    std::pair<engine::Shader&, const GeometryUniforms&> Renderer::geometry_pass(
+        std::optional<size_t> light_i
+    ) const {
+        if(light_i.has_value() && this->instance_buffers) {
+            return { *this->shadow_inst_shader, this->shadow_inst_uniforms };
+        }
+        if(light_i.has_value()) {
+            return { *this->shadow_shader, this->shadow_uniforms };
+        }
+        if(this->instance_buffers) {
+            return { *this->geometry_inst_shader, this->geometry_inst_uniforms };
+        }
+        return { *this->geometry_shader, this->geometry_uniforms };
+    }
+
+    const Frustum& Renderer::pass_frustum(std::optional<size_t> light_i) const {
+        static const Frustum everything = Frustum();
+        if(!light_i.has_value()) { return this->camera_frustum; }
+        if(*light_i >= this->light_frustums.size()) { return everything; }
+        return this->light_frustums[*light_i];
+    }
+
+    std::span<const Mat<4>> Renderer::cull_instances(
+        const Vec<3>& bounds_center, f64 bounds_radius,
+        std::span<const Mat<4>> model_transforms,
+        std::optional<size_t> light_i
+    ) {
+        bool skip = !this->frustum_culling || std::isinf(bounds_radius);
+        if(skip) {
+            this->culling.drawn += model_transforms.size();
+            return model_transforms;
+        }
+        const Frustum& frustum = this->pass_frustum(light_i);
+        Vec<4> center = bounds_center.with(1.0);
+        this->visible_transforms.clear();
+        for(const Mat<4>& transform: model_transforms) {
+            // the largest scale of any axis of the transform
+            f64 scale = 0.0;
+            for(size_t column_i = 0; column_i < 3; column_i += 1) {
+                f64 axis_scale = transform.columns[column_i]
+                    .swizzle<3>("xyz").len();
+                scale = std::max(scale, axis_scale);
+            }
+            Vec<3> world_center = (transform * center).swizzle<3>("xyz");
+            if(!frustum.contains_sphere(world_center, bounds_radius * scale)) {
+                continue;
+            }
+            this->visible_transforms.push_back(transform);
+        }
+        size_t visible = this->visible_transforms.size();
+        this->culling.drawn += visible;
+        this->culling.culled += model_transforms.size() - visible;
+        if(visible == model_transforms.size()) { return model_transforms; }
+        return this->visible_transforms;
     }
 
     void Renderer::render(
@@ -133,47 +291,160 @@ namespace houseofatmos {
         engine::FaceCulling face_culling,
         engine::DepthTesting depth_testing,
         std::optional<size_t> light_i
+    ) {
+        if(this->recording && !light_i.has_value()) {
+            DrawCall& draw = this->recorded_draws.emplace_back();
+            draw.mesh = &mesh;
+            draw.texture = &texture;
+            draw.local_transform = local_transform;
+            draw.first_transform = this->recorded_transforms.size();
+            draw.transform_count = model_transforms.size();
+            this->recorded_transforms.insert(
+                this->recorded_transforms.end(), 
+                model_transforms.begin(), model_transforms.end()
+            );
+            draw.first_joint = this->recorded_joints.size();
+            draw.joint_count = joint_transforms.size();
+            this->recorded_joints.insert(
+                this->recorded_joints.end(), 
+                joint_transforms.begin(), joint_transforms.end()
+            );
+            draw.face_culling = face_culling;
+            draw.depth_testing = depth_testing;
+            return;
+        }
+        this->draw_mesh(
+            mesh, texture, local_transform, model_transforms, joint_transforms,
+            face_culling, depth_testing, light_i, std::nullopt
+        );
+    }
+
+    void Renderer::draw_mesh(
+        engine::Mesh& mesh, 
+        const engine::Texture& texture,
+        const Mat<4>& local_transform,
+        std::span<const Mat<4>> model_transforms,
+        std::span<const Mat<4>> joint_transforms,
+        engine::FaceCulling face_culling,
+        engine::DepthTesting depth_testing,
+        std::optional<size_t> light_i,
+        std::optional<size_t> uploaded_instance
     ) {
         bool render_all_light_maps = this->rendering_shadow_maps
             && !light_i.has_value() 
             && depth_testing == engine::DepthTesting::Enabled; 
         if(render_all_light_maps) {
             for(size_t light_i = 0; light_i < this->lights.size(); light_i += 1) {
-                this->render(
+                this->draw_mesh(
                     mesh, texture, local_transform, 
                     model_transforms, joint_transforms,
                     engine::FaceCulling::Disabled,
                     engine::DepthTesting::Enabled, 
-                    light_i
+                    light_i, uploaded_instance
                 );
             }
             return;
         }
-        engine::Shader& shader = light_i.has_value()
-            ? *this->shadow_shader : *this->geometry_shader;
-        shader.set_uniform("u_view_proj", light_i.has_value()
+        // the bounds of meshes are unknown, meaning they are never culled
+        this->culling.drawn += model_transforms.size();
+        auto [shader, uniforms] = this->geometry_pass(light_i);
+        shader.set_uniform(uniforms.view_proj, light_i.has_value()
             ? this->lights[*light_i].compute_view_proj() 
             : this->compute_view_proj()
         );
-        shader.set_uniform("u_local_transf", local_transform);
-        shader.set_uniform("u_joint_transfs", joint_transforms);
-        shader.set_uniform("u_texture", texture);
+        shader.set_uniform(uniforms.local_transf, local_transform);
+        shader.set_uniform(uniforms.joint_transfs, joint_transforms);
+        shader.set_uniform(uniforms.texture, texture);
         engine::RenderTarget dest = light_i.has_value()
             ? this->shadow_maps.as_target(*light_i) : this->target.as_target();
+        const engine::InstanceBuffer* instances = this->instance_buffers
+            ? &this->instances : nullptr;
+        // instance attributes allow drawing all instances at once
+        size_t batch_size = this->instance_buffers
+            ? model_transforms.size() : Renderer::max_inst_c;
         for(size_t completed = 0; completed < model_transforms.size();) {
             size_t remaining = model_transforms.size() - completed;
-            size_t count = std::min(remaining, Renderer::max_inst_c);
-            shader.set_uniform(
-                "u_model_transfs", 
-                model_transforms.subspan(completed, count)
-            );
+            size_t count = std::min(remaining, batch_size);
+            std::span<const Mat<4>> batch 
+                = model_transforms.subspan(completed, count);
+            size_t first_instance = 0;
+            if(instances != nullptr) {
+                first_instance = uploaded_instance.has_value()
+                    ? *uploaded_instance : this->upload_instances(batch);
+            } else {
+                shader.set_uniform(uniforms.model_transfs, batch);
+            }
             mesh.render(
-                shader, dest, count, face_culling, depth_testing
+                shader, dest, count, face_culling, depth_testing,
+                instances, first_instance
             );
             completed += count;
         }
     }
 
+    void Renderer::render_terrain(
+        engine::Mesh& mesh,
+        const engine::Texture& texture,
+        const Mat<4>& model_transform,
+        const Vec<3>& bounds_center, f64 bounds_radius,
+        std::optional<size_t> light_i
+    ) {
+        if(this->recording && !light_i.has_value()) {
+            DrawCall& draw = this->recorded_draws.emplace_back();
+            draw.mesh = &mesh;
+            draw.terrain = true;
+            draw.texture = &texture;
+            draw.local_transform = model_transform;
+            draw.bounds_center = bounds_center;
+            draw.bounds_radius = bounds_radius;
+            return;
+        }
+        this->draw_terrain(
+            mesh, texture, model_transform, bounds_center, bounds_radius, 
+            light_i
+        );
+    }
+
+    void Renderer::draw_terrain(
+        engine::Mesh& mesh,
+        const engine::Texture& texture,
+        const Mat<4>& model_transform,
+        const Vec<3>& bounds_center, f64 bounds_radius,
+        std::optional<size_t> light_i
+    ) {
+        if(this->rendering_shadow_maps && !light_i.has_value()) {
+            for(size_t light_i = 0; light_i < this->lights.size(); light_i += 1) {
+                this->draw_terrain(
+                    mesh, texture, model_transform, 
+                    bounds_center, bounds_radius, light_i
+                );
+            }
+            return;
+        }
+        std::span<const Mat<4>> visible = this->cull_instances(
+            bounds_center, bounds_radius, 
+            std::span(&model_transform, 1), light_i
+        );
+        if(visible.size() == 0) { return; }
+        engine::Shader& shader = light_i.has_value()
+            ? *this->terrain_shadow_shader : *this->terrain_shader;
+        const TerrainUniforms& uniforms = light_i.has_value()
+            ? this->terrain_shadow_uniforms : this->terrain_uniforms;
+        shader.set_uniform(uniforms.view_proj, light_i.has_value()
+            ? this->lights[*light_i].compute_view_proj() 
+            : this->compute_view_proj()
+        );
+        shader.set_uniform(uniforms.model_transf, model_transform);
+        shader.set_uniform(uniforms.texture, texture);
+        engine::RenderTarget dest = light_i.has_value()
+            ? this->shadow_maps.as_target(*light_i) : this->target.as_target();
+        engine::FaceCulling face_culling = light_i.has_value()
+            ? engine::FaceCulling::Disabled : engine::FaceCulling::Enabled;
+        mesh.render(
+            shader, dest, 1, face_culling, engine::DepthTesting::Enabled
+        );
+    }
+
     void Renderer::render(
         engine::Model& model,
         std::span<const Mat<4>> model_transforms,
@@ -183,56 +454,113 @@ namespace houseofatmos {
         engine::DepthTesting depth_testing,
         const engine::Texture* override_texture,
         std::optional<size_t> light_i
+    ) {
+        std::vector<std::vector<Mat<4>>> poses;
+        if(animation != nullptr) {
+            poses = model.compute_poses(*animation, timestamp);
+        }
+        if(this->recording && !light_i.has_value()) {
+            DrawCall& draw = this->recorded_draws.emplace_back();
+            draw.model = &model;
+            draw.texture = override_texture;
+            draw.first_transform = this->recorded_transforms.size();
+            draw.transform_count = model_transforms.size();
+            this->recorded_transforms.insert(
+                this->recorded_transforms.end(), 
+                model_transforms.begin(), model_transforms.end()
+            );
+            draw.animated = animation != nullptr;
+            draw.poses = std::move(poses);
+            draw.face_culling = face_culling;
+            draw.depth_testing = depth_testing;
+            return;
+        }
+        this->draw_model(
+            model, model_transforms, animation != nullptr? &poses : nullptr,
+            face_culling, depth_testing, override_texture, 
+            light_i, std::nullopt
+        );
+    }
+
+    void Renderer::draw_model(
+        engine::Model& model,
+        std::span<const Mat<4>> model_transforms,
+        const std::vector<std::vector<Mat<4>>>* poses,
+        engine::FaceCulling face_culling,
+        engine::DepthTesting depth_testing,
+        const engine::Texture* override_texture,
+        std::optional<size_t> light_i,
+        std::optional<size_t> uploaded_instance
     ) {
         bool render_all_light_maps = this->rendering_shadow_maps
             && !light_i.has_value() 
             && depth_testing == engine::DepthTesting::Enabled; 
         if(render_all_light_maps) {
             for(size_t light_i = 0; light_i < this->lights.size(); light_i += 1) {
-                this->render(
-                    model, model_transforms, animation, timestamp,
+                this->draw_model(
+                    model, model_transforms, poses,
                     engine::FaceCulling::Disabled,
                     engine::DepthTesting::Enabled, 
-                    override_texture, light_i
+                    override_texture, light_i, uploaded_instance
                 );
             }
             return;
         }
-        engine::Shader& shader = light_i.has_value()
-            ? *this->shadow_shader : *this->geometry_shader;
-        shader.set_uniform("u_view_proj", light_i.has_value()
+        std::span<const Mat<4>> visible = this->cull_instances(
+            model.bounds_center(), model.bounds_radius(), 
+            model_transforms, light_i
+        );
+        if(visible.size() == 0) { return; }
+        // the uploaded instances can only be used if none were culled
+        if(visible.size() != model_transforms.size()) {
+            uploaded_instance = std::nullopt;
+        }
+        model_transforms = visible;
+        auto [shader, uniforms] = this->geometry_pass(light_i);
+        shader.set_uniform(uniforms.view_proj, light_i.has_value()
             ? this->lights[*light_i].compute_view_proj() 
             : this->compute_view_proj()
         );
         if(override_texture != nullptr) {
-            shader.set_uniform("u_texture", *override_texture);
+            shader.set_uniform(uniforms.texture, *override_texture);
         }
         engine::RenderTarget dest = light_i.has_value()
             ? this->shadow_maps.as_target(*light_i) : this->target.as_target();
+        const engine::InstanceBuffer* instances = this->instance_buffers
+            ? &this->instances : nullptr;
+        // instance attributes allow drawing all instances at once
+        size_t batch_size = this->instance_buffers
+            ? model_transforms.size() : Renderer::max_inst_c;
         for(size_t completed = 0; completed < model_transforms.size();) {
             size_t remaining = model_transforms.size() - completed;
-            size_t count = std::min(remaining, Renderer::max_inst_c);
-            shader.set_uniform(
-                "u_model_transfs", 
-                model_transforms.subspan(completed, count)
-            );
-            if(animation == nullptr) {
+            size_t count = std::min(remaining, batch_size);
+            std::span<const Mat<4>> batch 
+                = model_transforms.subspan(completed, count);
+            size_t first_instance = 0;
+            if(instances != nullptr) {
+                first_instance = uploaded_instance.has_value()
+                    ? *uploaded_instance : this->upload_instances(batch);
+            } else {
+                shader.set_uniform(uniforms.model_transfs, batch);
+            }
+            if(poses == nullptr) {
                 model.render_all(
-                    shader, dest, "u_local_transf",
+                    shader, dest, uniforms.local_transf,
                     override_texture == nullptr
-                        ? std::optional("u_texture") : std::nullopt,
-                    "u_joint_transfs",
-                    count, face_culling, depth_testing
+                        ? std::optional(uniforms.texture) : std::nullopt,
+                    uniforms.joint_transfs,
+                    count, face_culling, depth_testing,
+                    instances, first_instance
                 );
             } else {
-                model.render_all_animated(
-                    shader, dest,
-                    *animation, timestamp,
-                    "u_joint_transfs", 
-                    "u_local_transf",
+                model.render_all_posed(
+                    shader, dest, *poses,
+                    uniforms.joint_transfs, 
+                    uniforms.local_transf,
                     override_texture == nullptr
-                        ? std::optional("u_texture") : std::nullopt, 
-                    count, face_culling, depth_testing
+                        ? std::optional(uniforms.texture) : std::nullopt, 
+                    count, face_culling, depth_testing,
+                    instances, first_instance
                 );
             }
             completed += count;
@@ -240,4 +568,69 @@ namespace houseofatmos {
 
     }
 
+
+    void Renderer::begin_recording() {
+        this->recording = true;
+        this->recorded_draws.clear();
+        this->recorded_transforms.clear();
+        this->recorded_joints.clear();
+        this->recorded_first_instance = std::nullopt;
+    }
+
+    void Renderer::end_recording() {
+        this->recording = false;
+        // upload the instances of all recorded draws at once,
+        // which are then shared by all passes
+        bool upload = this->instance_buffers 
+            && this->recorded_transforms.size() > 0;
+        if(upload) {
+            // draws with culled instances upload the visible ones again
+            // in each pass, which must not orphan the recorded instances
+            size_t passes = this->frustum_culling
+                ? this->lights.size() + 1 : 0;
+            this->instances.reserve(
+                this->recorded_transforms.size() * (passes + 1)
+            );
+            this->recorded_first_instance 
+                = this->upload_instances(this->recorded_transforms);
+        }
+    }
+
+    void Renderer::replay() {
+        std::span<const Mat<4>> transforms = this->recorded_transforms;
+        std::span<const Mat<4>> joints = this->recorded_joints;
+        for(const DrawCall& draw: this->recorded_draws) {
+            if(draw.terrain) {
+                this->draw_terrain(
+                    *draw.mesh, *draw.texture, draw.local_transform, 
+                    draw.bounds_center, draw.bounds_radius, std::nullopt
+                );
+                continue;
+            }
+            std::span<const Mat<4>> model_transforms
+                = transforms.subspan(draw.first_transform, draw.transform_count);
+            std::optional<size_t> first_instance = std::nullopt;
+            if(this->recorded_first_instance.has_value()) {
+                first_instance = *this->recorded_first_instance 
+                    + draw.first_transform;
+            }
+            if(draw.mesh != nullptr) {
+                this->draw_mesh(
+                    *draw.mesh, *draw.texture, draw.local_transform,
+                    model_transforms, 
+                    joints.subspan(draw.first_joint, draw.joint_count),
+                    draw.face_culling, draw.depth_testing, 
+                    std::nullopt, first_instance
+                );
+            } else {
+                this->draw_model(
+                    *draw.model, model_transforms, 
+                    draw.animated? &draw.poses : nullptr,
+                    draw.face_culling, draw.depth_testing, draw.texture,
+                    std::nullopt, first_instance
+                );
+            }
+        }
+    }
+
 }
\ No newline at end of file
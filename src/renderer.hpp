@@ -21,8 +21,45 @@ namespace houseofatmos {
     };
 
 
+    // Planes bounding a view volume, with their normals pointing inwards.
+    // A default constructed frustum contains everything.
+    struct Frustum {
+        std::array<Vec<4>, 6> planes;
+
+        static Frustum from_view_proj(const Mat<4>& view_proj);
+
+        bool contains_sphere(const Vec<3>& center, f64 radius) const;
+    };
+
+
     using ModelAttrib = std::pair<engine::Model::Attrib, engine::Mesh::Attrib>;
 
+
+    // uniforms set for every draw, resolved once per frame by the renderer
+    struct GeometryUniforms {
+        engine::Shader::Uniform view_proj = "u_view_proj";
+        engine::Shader::Uniform local_transf = "u_local_transf";
+        engine::Shader::Uniform joint_transfs = "u_joint_transfs";
+        engine::Shader::Uniform texture = "u_texture";
+        engine::Shader::Uniform model_transfs = "u_model_transfs";
+
+        // 'u_model_transfs' is only used if there are no instance attributes
+        void resolve(engine::Shader& shader, bool instance_attribs);
+    };
+
+    struct TerrainUniforms {
+        engine::Shader::Uniform view_proj = "u_view_proj";
+        engine::Shader::Uniform model_transf = "u_model_transf";
+        engine::Shader::Uniform texture = "u_texture";
+
+        void resolve(engine::Shader& shader);
+    };
+
+    struct CullingStats {
+        u64 drawn; // objects drawn in any pass
+        u64 culled; // objects skipped in any pass for being out of view
+    };
+
     struct Renderer {
 
         static const inline std::vector<engine::Mesh::Attrib> mesh_attribs = {
@@ -32,6 +69,20 @@ namespace houseofatmos {
             engine::Mesh::Attrib(engine::Mesh::U8,  4),
             engine::Mesh::Attrib(engine::Mesh::F32, 4)
         };
+        // chunk-relative integer positions, normals scaled by 127 and
+        // the corner and cell of the terrain texture (see 'terrain_vert.glsl')
+        static const inline std::vector<engine::Mesh::Attrib> terrain_attribs = {
+            engine::Mesh::Attrib(engine::Mesh::I16, 3),
+            engine::Mesh::Attrib(engine::Mesh::I8,  4),
+            engine::Mesh::Attrib(engine::Mesh::U8,  2)
+        };
+        // model transform, bound to the locations after the mesh attributes
+        static const inline std::vector<engine::Mesh::Attrib> instance_attribs = {
+            engine::Mesh::Attrib(engine::Mesh::F32, 4),
+            engine::Mesh::Attrib(engine::Mesh::F32, 4),
+            engine::Mesh::Attrib(engine::Mesh::F32, 4),
+            engine::Mesh::Attrib(engine::Mesh::F32, 4)
+        };
         static const inline std::vector<ModelAttrib> model_attribs = {
             ModelAttrib(engine::Model::Position, { engine::Mesh::F32, 3 }), 
             ModelAttrib(engine::Model::UvMapping, { engine::Mesh::F32, 2 }), 
@@ -48,6 +99,22 @@ namespace houseofatmos {
             "res/shaders/geometry_vert.glsl", "res/shaders/geometry_frag.glsl"
         };
 
+        static const inline engine::Shader::LoadArgs shadow_inst_shader_args = {
+            "res/shaders/geometry_inst_vert.glsl", "res/shaders/shadow_frag.glsl"
+        };
+
+        static const inline engine::Shader::LoadArgs geometry_inst_shader_args = {
+            "res/shaders/geometry_inst_vert.glsl", "res/shaders/geometry_frag.glsl"
+        };
+
+        static const inline engine::Shader::LoadArgs terrain_shadow_shader_args = {
+            "res/shaders/terrain_vert.glsl", "res/shaders/shadow_frag.glsl"
+        };
+
+        static const inline engine::Shader::LoadArgs terrain_shader_args = {
+            "res/shaders/terrain_vert.glsl", "res/shaders/geometry_frag.glsl"
+        };
+
         static const inline engine::Texture::LoadArgs dither_pattern = {
             "res/dither_pattern.png"
         };
@@ -56,10 +123,88 @@ namespace houseofatmos {
         static const inline size_t max_light_c = 16;
 
         private:
+        // a draw made while recording, which is replayed for each pass
+        struct DrawCall {
+            engine::Mesh* mesh = nullptr; // mesh or terrain draw
+            engine::Model* model = nullptr; // model draw
+            bool terrain = false;
+            // mesh texture, or override texture of a model (may be null)
+            const engine::Texture* texture = nullptr;
+            // local transform, or model transform of terrain
+            Mat<4> local_transform;
+            // model space bounds of terrain
+            Vec<3> bounds_center;
+            f64 bounds_radius = INFINITY;
+            size_t first_transform = 0, transform_count = 0;
+            size_t first_joint = 0, joint_count = 0;
+            bool animated = false;
+            std::vector<std::vector<Mat<4>>> poses;
+            engine::FaceCulling face_culling = engine::FaceCulling::Enabled;
+            engine::DepthTesting depth_testing = engine::DepthTesting::Enabled;
+        };
+
         engine::Texture target = engine::Texture(100, 100);
         engine::TextureArray shadow_maps
             = engine::TextureArray(std::span<engine::Texture>()); 
         bool rendering_shadow_maps = false;
+        GeometryUniforms shadow_uniforms;
+        GeometryUniforms geometry_uniforms;
+        GeometryUniforms shadow_inst_uniforms;
+        GeometryUniforms geometry_inst_uniforms;
+        TerrainUniforms terrain_shadow_uniforms;
+        TerrainUniforms terrain_uniforms;
+        engine::InstanceBuffer instances 
+            = engine::InstanceBuffer(Renderer::instance_attribs);
+        std::vector<f32> instance_data;
+        bool recording = false;
+        std::vector<DrawCall> recorded_draws;
+        std::vector<Mat<4>> recorded_transforms;
+        std::vector<Mat<4>> recorded_joints;
+        std::optional<size_t> recorded_first_instance;
+        Frustum camera_frustum;
+        std::vector<Frustum> light_frustums;
+        std::vector<Mat<4>> visible_transforms;
+        CullingStats culling = { 0, 0 };
+
+        size_t upload_instances(std::span<const Mat<4>> model_transforms);
+        std::pair<engine::Shader&, const GeometryUniforms&> geometry_pass(
+            std::optional<size_t> light_i
+        ) const;
+        const Frustum& pass_frustum(std::optional<size_t> light_i) const;
+        std::span<const Mat<4>> cull_instances(
+            const Vec<3>& bounds_center, f64 bounds_radius,
+            std::span<const Mat<4>> model_transforms,
+            std::optional<size_t> light_i
+        );
+
+        void draw_mesh(
+            engine::Mesh& mesh, 
+            const engine::Texture& texture,
+            const Mat<4>& local_transform,
+            std::span<const Mat<4>> model_transforms,
+            std::span<const Mat<4>> joint_transforms,
+            engine::FaceCulling face_culling,
+            engine::DepthTesting depth_testing,
+            std::optional<size_t> light_i,
+            std::optional<size_t> uploaded_instance
+        );
+        void draw_terrain(
+            engine::Mesh& mesh,
+            const engine::Texture& texture,
+            const Mat<4>& model_transform,
+            const Vec<3>& bounds_center, f64 bounds_radius,
+            std::optional<size_t> light_i
+        );
+        void draw_model(
+            engine::Model& model,
+            std::span<const Mat<4>> model_transforms,
+            const std::vector<std::vector<Mat<4>>>* poses,
+            engine::FaceCulling face_culling,
+            engine::DepthTesting depth_testing,
+            const engine::Texture* override_texture,
+            std::optional<size_t> light_i,
+            std::optional<size_t> uploaded_instance
+        );
 
         public:
         Camera camera;
@@ -77,12 +222,28 @@ namespace houseofatmos {
         Vec<3> sun_direction = Vec<3>(0.0, 0.0, 0.0);
         f64 diffuse_min = 1.0;
         f64 diffuse_max = 1.0;
+        // Model transforms are passed as instance attributes if enabled,
+        // and as uniform arrays of at most 'max_inst_c' otherwise.
+        bool instance_buffers = true;
+        // Model instances and terrain outside of the view volume of the
+        // camera or light being rendered to are skipped if enabled.
+        bool frustum_culling = true;
+        // logs the culling and GL state change stats of the previous frame
+        bool log_frame_stats = false;
         engine::Shader* shadow_shader = nullptr;
         engine::Shader* geometry_shader = nullptr;
+        engine::Shader* shadow_inst_shader = nullptr;
+        engine::Shader* geometry_inst_shader = nullptr;
+        engine::Shader* terrain_shadow_shader = nullptr;
+        engine::Shader* terrain_shader = nullptr;
 
         static void load_shaders(engine::Scene& scene) {
             scene.load(Renderer::shadow_shader_args);
             scene.load(Renderer::geometry_shader_args);
+            scene.load(Renderer::shadow_inst_shader_args);
+            scene.load(Renderer::geometry_inst_shader_args);
+            scene.load(Renderer::terrain_shadow_shader_args);
+            scene.load(Renderer::terrain_shader_args);
             scene.load(Renderer::dither_pattern);
         }
 
@@ -101,6 +262,14 @@ namespace houseofatmos {
         void render_to_shadow_maps();
         void render_to_output();
 
+        // While recording, 'render' and 'render_terrain' only record draws
+        // (copying all transforms), which can then be replayed for each pass
+        // using 'replay' instead of traversing the scene again.
+        // Replays need to happen before any other draws are made.
+        void begin_recording();
+        void end_recording();
+        void replay();
+
         void render(
             engine::Mesh& mesh, 
             const engine::Texture& texture,
@@ -113,6 +282,16 @@ namespace houseofatmos {
             engine::DepthTesting depth_testing = engine::DepthTesting::Enabled,
             std::optional<size_t> light_i = std::nullopt
         );
+        // 'bounds_center' and 'bounds_radius' describe a sphere containing
+        // the terrain mesh, relative to 'model_transform'
+        void render_terrain(
+            engine::Mesh& mesh,
+            const engine::Texture& texture,
+            const Mat<4>& model_transform,
+            const Vec<3>& bounds_center = Vec<3>(0, 0, 0),
+            f64 bounds_radius = INFINITY,
+            std::optional<size_t> light_i = std::nullopt
+        );
         void render(
             engine::Model& model,
             std::span<const Mat<4>> model_transforms,
@@ -124,6 +303,12 @@ namespace houseofatmos {
             std::optional<size_t> light_i = std::nullopt
         );
 
+        // both reset by 'configure'
+        const CullingStats& culling_stats() const { return this->culling; }
+        const engine::RenderState::Stats& state_stats() const {
+            return engine::RenderState::stats();
+        }
+
         const engine::Texture& output() const { return this->target; }
         engine::Texture& output() { return this->target; }
 
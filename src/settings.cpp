@@ -68,6 +68,9 @@ namespace houseofatmos {
         if(j.contains("do_pixelation")) {
             s.do_pixelation = j.at("do_pixelation");
         }
+        if(j.contains("log_render_stats")) {
+            s.log_render_stats = j.at("log_render_stats");
+        }
         if(j.contains("last_games")) {
             for(const auto& path: j.at("last_games")) {
                 s.last_games.push_back(path);
@@ -87,6 +90,7 @@ namespace houseofatmos {
         serialized["signal_side_left"] = this->signal_side_left;
         serialized["do_dithering"] = this->do_dithering;
         serialized["do_pixelation"] = this->do_pixelation;
+        serialized["log_render_stats"] = this->log_render_stats;
         json last_games = json::array();
         for(const std::string& game: this->last_games) {
             last_games.push_back(game);
@@ -227,7 +231,7 @@ namespace houseofatmos {
         );
         ui::Element view_distance = Settings::create_slider(
             96.0, 8.0, 24.0,
-            1, 5, 1, this->view_distance, 
+            1, 10, 1, this->view_distance, 
             "", [this](f64 value) { 
                 this->view_distance = (u64) value;
             }
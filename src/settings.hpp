@@ -27,6 +27,7 @@ namespace houseofatmos {
         bool signal_side_left = true;
         bool do_dithering = true;
         bool do_pixelation = true;
+        bool log_render_stats = false;
         std::vector<std::string> last_games;
 
         Settings() {}
@@ -20,7 +20,6 @@ namespace houseofatmos {
         };
 
 
-        static inline std::list<ui::Element> empty_toasts;
         static inline const size_t max_toast_count = 10;
 
         private:
@@ -65,6 +64,7 @@ namespace houseofatmos {
 
         std::list<ui::Element>& elements() {
             if(this->toasts_container == nullptr) {
+                static std::list<ui::Element> empty_toasts;
                 empty_toasts.clear();
                 return empty_toasts;
             }
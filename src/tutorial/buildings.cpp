@@ -59,8 +59,8 @@ namespace houseofatmos::tutorial {
         auto update_scene = [scene](engine::Window& window) {
             (void) window;
             scene->world->personal_horse.pos = Vec<3>(INFINITY, 0, INFINITY);
-            for(auto& chunk: scene->world->terrain.all_loaded_chunks()) {
-                chunk.interactables.clear();
+            for(auto* chunk: scene->world->terrain.all_loaded_chunks()) {
+                chunk->interactables.clear();
             }
         };
         return {
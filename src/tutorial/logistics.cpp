@@ -97,8 +97,8 @@ namespace houseofatmos::tutorial {
         father->face_in_direction({ 1, 0, 0 });
         auto update_scene = [scene](engine::Window& window) {
             (void) window;
-            for(auto& chunk: scene->world->terrain.all_loaded_chunks()) {
-                chunk.interactables.clear();
+            for(auto* chunk: scene->world->terrain.all_loaded_chunks()) {
+                chunk->interactables.clear();
             }
         };
         return {
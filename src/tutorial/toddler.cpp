@@ -20,6 +20,7 @@ namespace houseofatmos::tutorial {
         world->terrain.bridges.push_back((world::Bridge) {
             world::Bridge::Stone, 29, 18, 36, 18, 3
         });
+        world->terrain.reindex_bridges();
         for_line(13, 23, 13, 25, set_path_at(world->terrain));
         for_line(10, 25, 20, 25, set_path_at(world->terrain));
         for_line(20, 25, 20, 31, set_path_at(world->terrain));
@@ -57,8 +58,8 @@ namespace houseofatmos::tutorial {
             scene->action_mode.remove_mode();
             scene->world->personal_horse.pos 
                 = Vec<3>(INFINITY, 0, INFINITY);
-            for(auto& chunk: scene->world->terrain.all_loaded_chunks()) {
-                chunk.interactables.clear();
+            for(auto* chunk: scene->world->terrain.all_loaded_chunks()) {
+                chunk->interactables.clear();
             }
         };
         auto await_father_standing = await_character_animation(
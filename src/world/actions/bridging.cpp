@@ -193,7 +193,17 @@ namespace houseofatmos::world {
                 && this->world->balance.pay_coins(cost, this->toasts);
             if(doing_placement) {
                 this->world->terrain.bridges.push_back(this->planned);
+                this->world->terrain.reindex_bridges();
+                this->world->carriages.network.mark_modified(
+                    (i64) this->planned.start_x, (i64) this->planned.start_z,
+                    (i64) this->planned.end_x, (i64) this->planned.end_z
+                );
                 this->world->carriages.reset(&this->toasts);
+                this->world->boats.network.mark_modified(
+                    (i64) this->planned.start_x, (i64) this->planned.start_z,
+                    (i64) this->planned.end_x, (i64) this->planned.end_z
+                );
+                this->world->boats.reset(&this->toasts);
                 this->speaker.position = tile_bounded_position(
                     this->planned.start_x, this->planned.start_z, 
                     this->planned.end_x, this->planned.end_z,
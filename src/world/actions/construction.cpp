@@ -689,8 +689,15 @@ namespace houseofatmos::world {
             (u8) (tile_z % terrain.tiles_per_chunk()),
             complex_id
         });
+        terrain.reindex_chunk_buildings(chunk_x, chunk_z);
         i64 end_x = (i64) (tile_x + type_info.width);
         i64 end_z = (i64) (tile_z + type_info.height);
+        terrain.reload_area(
+            (i64) tile_x, (i64) tile_z, end_x - 1, end_z - 1,
+            Terrain::ChunkGround | Terrain::ChunkBuildings 
+                | Terrain::ChunkResources | Terrain::ChunkInteractables
+                | Terrain::ChunkSpawners
+        );
         for(i64 u_tile_x = (i64) tile_x; u_tile_x < end_x; u_tile_x += 1) {
             for(i64 u_tile_z = (i64) tile_z; u_tile_z < end_z; u_tile_z += 1) {
                 terrain.remove_foliage_at(u_tile_x, u_tile_z);
@@ -733,6 +740,11 @@ namespace houseofatmos::world {
                     tile_x, tile_z, this->world->terrain, this->world->complexes,
                     *this->selected_type, type_info, *this->selected_variant
                 );
+                this->world->carriages.network.mark_modified(
+                    (i64) tile_x, (i64) tile_z,
+                    (i64) (tile_x + type_info.width - 1), 
+                    (i64) (tile_z + type_info.height - 1)
+                );
                 this->world->carriages.reset(&this->toasts);
                 this->world->populations.reset(
                     this->world->terrain, &this->toasts
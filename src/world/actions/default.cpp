@@ -76,8 +76,10 @@ namespace houseofatmos::world {
                 const TrackPiece& piece = chunk.track_pieces[pc_i];
                 if(piece.x != chunk_rx || piece.z != chunk_rz) { continue; }
                 auto piece_id = TrackPieceId(chunk_x, chunk_z, pc_i);
-                auto piece_node = world.trains.network.graph.at(piece_id);
-                bool is_ascending = piece_node.connected_low.size() == 0;
+                const TrackNetwork::Node& piece_node = world.trains.network
+                    .node_at(piece_id);
+                bool is_ascending = world.trains.network
+                    .connected_low(piece_node).size() == 0;
                 pos = TrackPosition(
                     piece_id, 
                     is_ascending
@@ -57,8 +57,14 @@ namespace houseofatmos::world {
                         this->world->complexes.delete_complex(complex_id);
                     }
                 }
+                i64 building_x = (i64) (building.selected->x
+                    + building.chunk_x * this->world->terrain.tiles_per_chunk());
+                i64 building_z = (i64) (building.selected->z
+                    + building.chunk_z * this->world->terrain.tiles_per_chunk());
                 size_t building_idx = building.selected - chunk.buildings.data();
                 chunk.buildings.erase(chunk.buildings.begin() + building_idx);
+                this->world->terrain
+                    .reindex_chunk_buildings(building.chunk_x, building.chunk_z);
                 u64 refunded = (u64) ((f64) b_type.cost * demolition_refund_factor);
                 this->world->balance.add_coins(refunded, this->toasts);
                 for(i64 ch_o_x = -1; ch_o_x <= 1; ch_o_x += 1) {
@@ -69,10 +75,20 @@ namespace houseofatmos::world {
                             && (u64) ch_x < this->world->terrain.width_in_chunks()
                             && (u64) ch_z < this->world->terrain.height_in_chunks();
                         if(!in_bounds) { continue; }
-                        this->world->terrain
-                            .reload_chunk_at((u64) ch_x, (u64) ch_z);
+                        this->world->terrain.reload_chunk_at(
+                            (u64) ch_x, (u64) ch_z, 
+                            Terrain::ChunkGround | Terrain::ChunkBuildings
+                                | Terrain::ChunkResources 
+                                | Terrain::ChunkInteractables 
+                                | Terrain::ChunkSpawners
+                        );
                     }
                 }
+                this->world->carriages.network.mark_modified(
+                    building_x, building_z, 
+                    building_x + (i64) b_type.width - 1, 
+                    building_z + (i64) b_type.height - 1
+                );
                 this->world->carriages.reset(&this->toasts);
                 this->world->populations
                     .reset(this->world->terrain, &this->toasts);
@@ -114,19 +130,39 @@ namespace houseofatmos::world {
                             chunk.track_pieces.erase(
                                 chunk.track_pieces.begin() + tp_i
                             );
-                            this->world->terrain.reload_chunk_at(ch_x, ch_z);
+                            auto removed_id = TrackPieceId(ch_x, ch_z, tp_i);
+                            for(Train& train: this->world->trains.agents) {
+                                train.on_piece_removed(removed_id);
+                            }
+                            this->world->terrain.reload_chunk_at(
+                                ch_x, ch_z, Terrain::ChunkTrack
+                            );
                         }
                     }
                 }
                 u64 build_cost = bridge->length() * b_type.cost_per_tile;
                 u64 refunded = (u64) ((f64) build_cost * demolition_refund_factor);
+                this->world->carriages.network.mark_modified(
+                    (i64) bridge->start_x, (i64) bridge->start_z, 
+                    (i64) bridge->end_x, (i64) bridge->end_z
+                );
+                this->world->boats.network.mark_modified(
+                    (i64) bridge->start_x, (i64) bridge->start_z, 
+                    (i64) bridge->end_x, (i64) bridge->end_z
+                );
+                this->world->trains.network.mark_modified(
+                    (i64) bridge->start_x, (i64) bridge->start_z, 
+                    (i64) bridge->end_x, (i64) bridge->end_z
+                );
                 size_t bridge_idx = bridge - this->world->terrain.bridges.data();
                 this->world->terrain.bridges.erase(
                     this->world->terrain.bridges.begin() + bridge_idx
                 );
+                this->world->terrain.reindex_bridges();
                 this->world->balance.add_coins(refunded, this->toasts);
                 this->world->carriages.reset(&this->toasts);
                 this->world->boats.reset(&this->toasts);
+                this->world->trains.reset(&this->toasts);
                 this->selection.type = Selection::None;
                 this->speaker.play(scene.get(sound::demolish));
                 return;
@@ -158,10 +194,18 @@ namespace houseofatmos::world {
                 chunk.track_pieces.erase(
                     chunk.track_pieces.begin() + tp_s.piece_i
                 );
+                for(Train& train: this->world->trains.agents) {
+                    train.on_piece_removed(removed_id);
+                }
                 this->world->balance
                     .add_coins(track_removal_refund, this->toasts);
-                this->world->terrain
-                    .reload_chunk_at(tp_s.chunk_x, tp_s.chunk_z);
+                this->world->terrain.reload_chunk_at(
+                    tp_s.chunk_x, tp_s.chunk_z, Terrain::ChunkTrack
+                );
+                this->world->trains.network.mark_modified(
+                    (i64) tp_s.tile_x, (i64) tp_s.tile_z, 
+                    (i64) tp_s.tile_x, (i64) tp_s.tile_z
+                );
                 this->world->trains.reset(&this->toasts);
                 this->selection.type = Selection::None;
                 this->speaker.play(scene.get(sound::demolish));
@@ -18,28 +18,28 @@ namespace houseofatmos::world {
             (f32) this->world->terrain.elevation_at(left, top),
             (f32) (top * this->world->terrain.units_per_tile())
         });
-        u16 tl = overlay.complete_vertex();
+        u32 tl = overlay.complete_vertex();
         overlay.start_vertex();
         overlay.put_f32({
             (f32) (right * this->world->terrain.units_per_tile()),
             (f32) this->world->terrain.elevation_at(right, top),
             (f32) (top * this->world->terrain.units_per_tile())
         });
-        u16 tr = overlay.complete_vertex();
+        u32 tr = overlay.complete_vertex();
         overlay.start_vertex();
         overlay.put_f32({
             (f32) (left * this->world->terrain.units_per_tile()),
             (f32) this->world->terrain.elevation_at(left, bottom),
             (f32) (bottom * this->world->terrain.units_per_tile())
         });
-        u16 bl = overlay.complete_vertex();
+        u32 bl = overlay.complete_vertex();
         overlay.start_vertex();
         overlay.put_f32({
             (f32) (right * this->world->terrain.units_per_tile()),
             (f32) this->world->terrain.elevation_at(right, bottom),
             (f32) (bottom * this->world->terrain.units_per_tile())
         });
-        u16 br = overlay.complete_vertex();
+        u32 br = overlay.complete_vertex();
         // tl---tr
         //  | \ |
         // bl---br
@@ -89,7 +89,12 @@ namespace houseofatmos::world {
         if(place_path) {
             chunk.set_path_at(rel_x, rel_z, true);
             this->world->terrain.remove_foliage_at((i64) tile_x, (i64) tile_z);
-            this->world->terrain.reload_chunk_at(chunk_x, chunk_z);
+            this->world->terrain.reload_chunk_at(
+                chunk_x, chunk_z, Terrain::ChunkGround | Terrain::ChunkResources
+            );
+            this->world->carriages.network.mark_modified(
+                (i64) tile_x, (i64) tile_z, (i64) tile_x, (i64) tile_z
+            );
             this->world->carriages.reset(&this->toasts);
             this->speaker.position = Vec<3>(tile_x, 0, tile_z)
                 * this->world->terrain.units_per_tile()
@@ -97,7 +102,12 @@ namespace houseofatmos::world {
             this->speaker.play(scene.get(sound::terrain_mod));
         } else if(has_path && window.is_down(engine::Button::Right)) {
             chunk.set_path_at(rel_x, rel_z, false);
-            this->world->terrain.reload_chunk_at(chunk_x, chunk_z);
+            this->world->terrain.reload_chunk_at(
+                chunk_x, chunk_z, Terrain::ChunkGround | Terrain::ChunkResources
+            );
+            this->world->carriages.network.mark_modified(
+                (i64) tile_x, (i64) tile_z, (i64) tile_x, (i64) tile_z
+            );
             this->world->carriages.reset(&this->toasts);
             this->world->balance.add_coins(path_removal_refund, this->toasts);
             this->speaker.position = Vec<3>(tile_x, 0, tile_z)
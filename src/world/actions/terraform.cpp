@@ -134,6 +134,10 @@ namespace houseofatmos::world {
                 }
             }
         }
+        terrain.reload_area(
+            (i64) min_x - 1, (i64) min_z - 1, (i64) max_x, (i64) max_z,
+            Terrain::ChunkGround | Terrain::ChunkWater | Terrain::ChunkResources
+        );
     }
 
     static const u64 terrain_mod_cost_per_unit = 50;
@@ -195,6 +199,15 @@ namespace houseofatmos::world {
                 this->world->terrain.adjust_area_foliage(
                     min_x - 1, min_z - 1, max_x + 1, max_z + 1
                 );
+                // paths may have been removed by the modification
+                this->world->carriages.network.mark_modified(
+                    (i64) min_x - 1, (i64) min_z - 1, (i64) max_x, (i64) max_z
+                );
+                this->world->carriages.reset(&this->toasts);
+                this->world->boats.network.mark_modified(
+                    (i64) min_x - 1, (i64) min_z - 1, 
+                    (i64) max_x + 1, (i64) max_z + 1
+                );
                 this->world->boats.reset(&this->toasts);
                 this->speaker.position = tile_bounded_position(
                     min_x, min_z, max_x, max_z,
@@ -34,7 +34,9 @@ namespace houseofatmos::world {
             != encountered.end();
         if(skip) { return; }
         encountered.push_back(current);
-        const TrackNetwork::Node& n = network.graph.at(current);
+        const TrackNetwork::Node& n = network.node_at(current);
+        std::span<const TrackNetwork::NodeId> n_low = network.connected_low(n);
+        std::span<const TrackNetwork::NodeId> n_high = network.connected_high(n);
         const TrackPiece& current_p = network.track_piece_at(current);
         u64 t_x = current.chunk_x * terrain.tiles_per_chunk() + current_p.x;
         u64 t_z = current.chunk_z * terrain.tiles_per_chunk() + current_p.z;
@@ -44,27 +46,27 @@ namespace houseofatmos::world {
         TrackPiece* piece = pieces[0];
         if(!previous.has_value()) {
             piece->direction = value;
-            if(n.connected_low.size() == 1) {
+            if(n_low.size() == 1) {
                 fill_track_directions(
                     terrain, network, encountered, 
-                    n.connected_low[0], value, current
+                    n_low[0], value, current
                 );
             }
-            if(n.connected_high.size() == 1) {
+            if(n_high.size() == 1) {
                 TrackPiece::Direction inv_val
                     = value == TrackPiece::Ascending? TrackPiece::Descending
                     : value == TrackPiece::Descending? TrackPiece::Ascending
                     : TrackPiece::Any;
                 fill_track_directions(
                     terrain, network, encountered, 
-                    n.connected_high[0], inv_val, current
+                    n_high[0], inv_val, current
                 );
             }
             return;
         }
         bool prev_in_low = std::find(
-            n.connected_low.begin(), n.connected_low.end(), *previous
-        ) != n.connected_low.end();
+            n_low.begin(), n_low.end(), *previous
+        ) != n_low.end();
         switch(value) {
             case TrackPiece::Any: piece->direction = value; break;
             case TrackPiece::Ascending:
@@ -78,13 +80,13 @@ namespace houseofatmos::world {
                     : TrackPiece::Descending;
                 break;
         }
-        for(TrackNetwork::NodeId connected: n.connected_low) {
+        for(TrackNetwork::NodeId connected: n_low) {
             fill_track_directions(
                 terrain, network, encountered, 
                 connected, value, current
             );
         }
-        for(TrackNetwork::NodeId connected: n.connected_high) {
+        for(TrackNetwork::NodeId connected: n_high) {
             fill_track_directions(
                 terrain, network, encountered, 
                 connected, value, current
@@ -92,6 +94,18 @@ namespace houseofatmos::world {
         }
     }
 
+    static void mark_track_pieces_modified(
+        TrackNetwork& network, const std::vector<TrackNetwork::NodeId>& pieces
+    ) {
+        u64 tpc = network.terrain->tiles_per_chunk();
+        for(TrackNetwork::NodeId piece_id: pieces) {
+            const TrackPiece& piece = network.track_piece_at(piece_id);
+            i64 t_x = (i64) (piece_id.chunk_x * tpc + piece.x);
+            i64 t_z = (i64) (piece_id.chunk_z * tpc + piece.z);
+            network.mark_modified(t_x, t_z, t_x, t_z);
+        }
+    }
+
     static const i64 track_marker_ch_rad = 1;
     static const f64 max_display_tile_dist = 3;
 
@@ -223,6 +237,9 @@ namespace houseofatmos::world {
                                 this->world->trains.network, 
                                 modified, piece_id, d
                             );
+                            mark_track_pieces_modified(
+                                this->world->trains.network, modified
+                            );
                             this->world->trains.reset(&this->toasts);
                         })
                         .as_movable()
@@ -429,7 +446,13 @@ namespace houseofatmos::world {
             Terrain::ChunkData& chunk = this->world->terrain
                 .chunk_at(this->preview_ch_x, this->preview_ch_z);
             chunk.track_pieces.push_back(this->preview_piece);
+            this->world->terrain.reload_chunk_at(
+                this->preview_ch_x, this->preview_ch_z, Terrain::ChunkTrack
+            );
             this->world->terrain.remove_foliage_at((i64) dx, (i64) dz);
+            this->world->trains.network.mark_modified(
+                (i64) dx, (i64) dz, (i64) dx, (i64) dz
+            );
             this->world->trains.reset(&this->toasts);
             this->speaker.position = Vec<3>(dx + 0.5, 0.0, dz + 0.5)
                 * this->world->terrain.units_per_tile()
@@ -7,21 +7,75 @@
 #include "../player.hpp"
 #include "../interactable.hpp"
 #include <algorithm>
+#include <atomic>
+#include <memory>
 
 namespace houseofatmos::world {
 
     using namespace houseofatmos::engine::math;
 
 
+    template<typename NodeId>
+    struct NodeSearchState {
+        u64 start_dist;
+        u64 target_dist;
+        std::optional<NodeId> parent;
+        bool explored = false;
+    };
+
+    // entries of the open list are never updated in place - 
+    // if a shorter path to a node is found the node simply gets pushed
+    // again, and any outdated entries are skipped when popped
+    template<typename NodeId>
+    struct OpenSearchNode {
+        u64 total_cost;
+        u64 start_dist;
+        NodeId node;
+
+        bool operator>(const OpenSearchNode& other) const {
+            return this->total_cost > other.total_cost;
+        }
+    };
+
+    template<typename NodeId, typename NodeIdHash>
+    struct HashedSearchStates {
+        using State = NodeSearchState<NodeId>;
+
+        private:
+        std::unordered_map<NodeId, State, NodeIdHash> states;
+
+        public:
+        void begin_search() {
+            this->states.clear(); // keeps the allocated buckets
+        }
+
+        State& at(const NodeId& node) { return this->states.at(node); }
+
+        std::pair<State*, bool> insert(const NodeId& node) {
+            auto [state, inserted] = this->states.try_emplace(
+                node, UINT64_MAX, 0, std::nullopt
+            );
+            return { &state->second, inserted };
+        }
+    };
+
+
     template<typename NetworkNode>
     struct AgentNetwork {
         using NodeId = NetworkNode::NodeId;
         using NodeIdHash = NetworkNode::NodeIdHash;
+        using SearchStates = NetworkNode::SearchStates;
 
 
         ComplexBank* complexes;
         const Terrain* terrain;
         std::string local_lost_msg;
+        u64 generation = 0; // incremented on each reset
+
+        // reused by all searches on this network to avoid reallocating
+        SearchStates search_states;
+        std::vector<OpenSearchNode<NodeId>> search_open;
+        std::vector<std::pair<NodeId, u64>> search_connected;
 
         AgentNetwork(
             ComplexBank* complexes, const Terrain* terrain, 
@@ -33,6 +87,26 @@ namespace houseofatmos::world {
         AgentNetwork& operator=(AgentNetwork&& other) noexcept = default;
 
 
+        struct ModifiedArea {
+            u64 min_x, min_z, max_x, max_z; // in tiles, inclusive
+        };
+
+        // tile areas modified since the last reset - networks may use these
+        // to only partially rebuild themselves
+        std::vector<ModifiedArea> modified_areas;
+
+        void mark_modified(i64 min_x, i64 min_z, i64 max_x, i64 max_z) {
+            i64 last_x = (i64) this->terrain->width_in_tiles() - 1;
+            i64 last_z = (i64) this->terrain->height_in_tiles() - 1;
+            this->modified_areas.push_back((ModifiedArea) {
+                (u64) std::clamp(min_x, (i64) 0, last_x),
+                (u64) std::clamp(min_z, (i64) 0, last_z),
+                (u64) std::clamp(max_x, (i64) 0, last_x),
+                (u64) std::clamp(max_z, (i64) 0, last_z)
+            });
+        }
+
+
         const TrackPiece& track_piece_at(const NodeId& node_id) const {
             const Terrain::ChunkData& chunk 
                 = this->terrain->chunk_at(node_id.chunk_x, node_id.chunk_z);
@@ -84,39 +158,32 @@ namespace houseofatmos::world {
         std::vector<NodeId> points;
 
         private:
-        struct NodeSearchState {
-            u64 start_dist;
-            u64 target_dist;
-            std::optional<NodeId> parent;
-            bool explored = false;
-        };
-
-        using NodeSearchStates = std::unordered_map<
-            NodeId, NodeSearchState, NodeIdHash
-        >;
+        using SearchStates = Network::SearchStates;
+        using OpenNode = OpenSearchNode<NodeId>;
 
         static std::optional<NodeId> cheapest_node(
-            const NodeSearchStates& nodes
+            SearchStates& nodes, std::vector<OpenNode>& open
         ) {
-            u64 cheapest_cost = UINT64_MAX;
-            std::optional<NodeId> found_node = std::nullopt;
-            for(const auto& [node, state]: nodes) {
-                if(state.explored) { continue; }
-                u64 total_cost = state.start_dist + state.target_dist;
-                if(total_cost >= cheapest_cost) { continue; }
-                cheapest_cost = total_cost;
-                found_node = node;
+            while(!open.empty()) {
+                std::pop_heap(open.begin(), open.end(), std::greater<>());
+                OpenNode cheapest = open.back();
+                open.pop_back();
+                const NodeSearchState<NodeId>& state = nodes.at(cheapest.node);
+                bool is_outdated = state.explored
+                    || cheapest.start_dist != state.start_dist;
+                if(is_outdated) { continue; }
+                return cheapest.node;
             }
-            return found_node;
+            return std::nullopt;
         }
 
         static AgentPath<Network> build_path(
-            const NodeSearchStates& nodes, NodeId last
+            SearchStates& nodes, NodeId last
         ) {
             auto path = AgentPath<Network>();
             NodeId current = last;
             for(;;) {
-                const NodeSearchState& state = nodes.at(current);
+                const NodeSearchState<NodeId>& state = nodes.at(current);
                 if(!state.parent.has_value()) { break; }
                 path.points.push_back(current);
                 current = *state.parent;
@@ -130,16 +197,23 @@ namespace houseofatmos::world {
             Network& network, NodeId start, ComplexId target,
             std::optional<NodeId> start_parent = std::nullopt
         ) {
-            NodeSearchStates nodes;
-            nodes[start] = NodeSearchState(
-                0, network.node_target_dist(start, target), std::nullopt
-            );
-            std::vector<std::pair<NodeId, u64>> connected;
+            SearchStates& nodes = network.search_states;
+            std::vector<OpenNode>& open = network.search_open;
+            std::vector<std::pair<NodeId, u64>>& connected
+                = network.search_connected;
+            nodes.begin_search();
+            open.clear();
+            connected.clear();
+            u64 start_target_dist = network.node_target_dist(start, target);
+            NodeSearchState<NodeId>& start_s = *nodes.insert(start).first;
+            start_s.start_dist = 0;
+            start_s.target_dist = start_target_dist;
+            open.push_back(OpenNode(start_target_dist, 0, start));
             for(;;) {
-                std::optional<NodeId> next = cheapest_node(nodes);
+                std::optional<NodeId> next = cheapest_node(nodes, open);
                 if(!next.has_value()) { return std::nullopt; }
                 NodeId current = *next;
-                NodeSearchState& current_s = nodes[current];
+                NodeSearchState<NodeId>& current_s = nodes.at(current);
                 current_s.explored = true;
                 if(network.node_at_target(current, target)) {
                     return build_path(nodes, current);
@@ -149,21 +223,23 @@ namespace houseofatmos::world {
                         ? current_s.parent : start_parent, 
                     current, connected
                 );
+                u64 current_start_dist = current_s.start_dist;
                 for(auto [neigh, step_dist]: connected) {
-                    u64 new_start_dist = current_s.start_dist + step_dist;
-                    if(!nodes.contains(neigh)) {
-                        nodes[neigh] = NodeSearchState(
-                            new_start_dist,
-                            network.node_target_dist(current, target),
-                            current
-                        );
-                    }
-                    NodeSearchState& neigh_s = nodes[neigh];
-                    bool new_path_shorter = new_start_dist < neigh_s.start_dist;
-                    if(new_path_shorter && !neigh_s.explored) {
-                        neigh_s.start_dist = new_start_dist;
-                        neigh_s.parent = current;
+                    u64 new_start_dist = current_start_dist + step_dist;
+                    auto [neigh_s, inserted] = nodes.insert(neigh);
+                    if(inserted) {
+                        neigh_s->target_dist = network
+                            .node_target_dist(neigh, target);
                     }
+                    bool new_path_shorter = new_start_dist < neigh_s->start_dist;
+                    if(!new_path_shorter || neigh_s->explored) { continue; }
+                    neigh_s->start_dist = new_start_dist;
+                    neigh_s->parent = current;
+                    open.push_back(OpenNode(
+                        new_start_dist + neigh_s->target_dist, 
+                        new_start_dist, neigh
+                    ));
+                    std::push_heap(open.begin(), open.end(), std::greater<>());
                 }
                 connected.clear();
             }
@@ -185,7 +261,19 @@ namespace houseofatmos::world {
     };
 
     enum struct AgentState {
-        Idle, Travelling, Loading, Lost
+        Idle, Routing, Travelling, Loading, Lost
+    };
+
+    // A search for a path that may still be running in the background.
+    template<typename Network>
+    struct PathRequest {
+        u64 network_generation;
+        std::optional<AgentPath<Network>> path;
+        // only read 'path' once this is set
+        std::atomic<bool> completed = false;
+
+        PathRequest(u64 network_generation): 
+            network_generation(network_generation) {}
     };
 
     struct SerializedAgent {
@@ -201,9 +289,14 @@ namespace houseofatmos::world {
         u64 stop_i = 0;
         std::unordered_map<Item::Type, u64> items;
 
+        // set if the agent shall be reported as lost should the currently 
+        // requested path not be found
+        bool report_if_lost = false;
+
         private:
         AgentState state = AgentState::Idle;
         std::optional<AgentPath<Network>> path;
+        std::shared_ptr<PathRequest<Network>> requested_path;
         f64 load_start_time = 0.0;
 
         public:
@@ -238,10 +331,31 @@ namespace houseofatmos::world {
             Network& network, ComplexId target
         ) = 0;
 
+        // Starts a search for a path to the given target. Unless overridden
+        // the search is done immediately using 'find_path_to'.
+        virtual std::shared_ptr<PathRequest<Network>> request_path_to(
+            Network& network, ComplexId target
+        ) {
+            auto request = std::make_shared<PathRequest<Network>>(
+                network.generation
+            );
+            request->path = this->find_path_to(network, target);
+            request->completed = true;
+            return request;
+        }
+
         virtual void on_network_reset(Network& network) {
             (void) network;
         }
 
+        // Attempts to keep using the current path after the network has
+        // been reset, repairing it if needed. Returns false if a new path
+        // needs to be searched for instead.
+        virtual bool repair_path(Network& network) {
+            (void) network;
+            return false;
+        }
+
         virtual void update(
             Network& network, engine::Scene& scene, 
             const engine::Window& window, ParticleManager* particles,
@@ -277,6 +391,9 @@ namespace houseofatmos::world {
         const std::optional<AgentPath<Network>>& current_path() const { 
             return this->path; 
         }
+        std::optional<AgentPath<Network>>& current_path() { 
+            return this->path; 
+        }
 
         void advance_next_stop() {
             this->stop_i += 1;
@@ -289,13 +406,38 @@ namespace houseofatmos::world {
         }
 
         void travel_to(Network& network, ComplexId target) {
-            auto found = this->find_path_to(network, target);
-            this->path = found;
-            if(!found.has_value()) {
-                this->state = AgentState::Lost;
+            this->path = std::nullopt;
+            this->state = AgentState::Routing;
+            this->requested_path = this->request_path_to(network, target);
+            this->receive_path(network);
+        }
+
+        // Takes the result of the requested path search should it be done.
+        // Results of searches started before the last reset are discarded
+        // and the search is started again.
+        void receive_path(Network& network) {
+            if(this->requested_path == nullptr) { return; }
+            if(!this->requested_path->completed) { return; }
+            std::shared_ptr<PathRequest<Network>> request
+                = std::move(this->requested_path);
+            this->requested_path = nullptr;
+            if(request->network_generation != network.generation) {
+                this->travel_to(network, this->next_stop().target);
                 return;
             }
-            this->state = AgentState::Travelling;
+            this->path = std::move(request->path);
+            this->state = this->path.has_value()
+                ? AgentState::Travelling : AgentState::Lost;
+        }
+
+        // Returns true if the agent became lost and was supposed to be 
+        // reported as such.
+        bool became_lost() {
+            if(this->state == AgentState::Routing) { return false; }
+            bool is_lost = this->report_if_lost 
+                && this->state == AgentState::Lost;
+            this->report_if_lost = false;
+            return is_lost;
         }
 
         void do_stop_transfer(Network& network, const AgentStop& stop) {
@@ -375,11 +517,16 @@ namespace houseofatmos::world {
             switch(this->state) {
                 case AgentState::Idle: {
                     this->path = std::nullopt;
+                    this->requested_path = nullptr;
                     if(this->schedule.size() >= 2) {
                         this->state = AgentState::Travelling;
                     }
                     break;
                 }
+                case AgentState::Routing: {
+                    this->receive_path(network);
+                    break;
+                }
                 case AgentState::Travelling: {
                     if(!this->path.has_value()) {
                         this->travel_to(network, this->next_stop().target);
@@ -458,24 +605,36 @@ namespace houseofatmos::world {
 
         void reset(Toasts* toasts) {
             this->network.reset();
-            bool any_became_lost = false;
+            this->network.generation += 1;
             for(Agent& agent: this->agents) {
                 agent.on_network_reset(this->network);
                 if(agent.current_state() == AgentState::Idle) { continue; }
+                bool is_travelling = agent.current_state() 
+                    == AgentState::Travelling;
+                if(is_travelling && agent.repair_path(this->network)) { 
+                    continue; 
+                }
                 bool was_lost = agent.current_state() == AgentState::Lost;
+                agent.report_if_lost = !was_lost && toasts != nullptr;
                 agent.travel_to(this->network, agent.next_stop().target);
-                bool is_lost = agent.current_state() == AgentState::Lost;
-                any_became_lost |= (!was_lost && is_lost);
             }
-            if(any_became_lost && toasts != nullptr) {
-                toasts->add_error(this->network.local_lost_msg, {});
+            if(toasts != nullptr) { this->report_lost_agents(*toasts); }
+        }
+
+        void report_lost_agents(Toasts& toasts) {
+            bool any_became_lost = false;
+            for(Agent& agent: this->agents) {
+                any_became_lost |= agent.became_lost();
+            }
+            if(any_became_lost) {
+                toasts.add_error(this->network.local_lost_msg, {});
             }
         }
 
         void update(
             engine::Scene& scene, const engine::Window& window,
             ParticleManager* particles,
-            Player& player, Interactables* interactables
+            Player& player, Interactables* interactables, Toasts& toasts
         ) {
             this->network.update(scene, window);
             for(Agent& agent: this->agents) {
@@ -485,6 +644,7 @@ namespace houseofatmos::world {
                     player, interactables
                 );
             }
+            this->report_lost_agents(toasts);
         }
 
         void render(
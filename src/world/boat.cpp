@@ -7,7 +7,7 @@ namespace houseofatmos::world {
     static const f64 water_level = -0.5;
     static inline const f64 min_allowed_bridge_height = 10.0;
 
-    bool BoatNetwork::is_passable(NodeId node) {
+    bool BoatNetwork::compute_passable(NodeId node) {
         auto [x, z] = node;
         bool xl = x == 0;
         bool zl = z == 0;
@@ -14,7 +14,10 @@ namespace houseofatmos::world {
         BoatNetwork(BoatNetwork&& other) noexcept = default;
         BoatNetwork& operator=(BoatNetwork&& other) noexcept = default;
 
-        bool is_passable(NodeId node) override;
+        bool compute_passable(NodeId node) override;
+
+        // open water is mostly made up of large uniform areas
+        bool uniform_costs() const override { return true; }
 
     };
 
@@ -5,7 +5,7 @@
 
 namespace houseofatmos::world {
 
-    bool CarriageNetwork::is_passable(NodeId node) {
+    bool CarriageNetwork::compute_passable(NodeId node) {
         auto [x, z] = node;
         bool has_path = this->terrain->path_at((i64) x, (i64) z)
             && this->terrain->building_at((i64) x, (i64) z) == nullptr;
@@ -189,7 +189,10 @@ namespace houseofatmos::world {
         }
         this->speaker.position = this->position;
         this->speaker.update();
-        bool play_state_sound = this->current_state() != this->prev_state
+        // waiting for a path doesn't count as a change in state, only the
+        // state after it does
+        bool play_state_sound = this->current_state() != AgentState::Routing
+            && this->current_state() != this->prev_state
             && this->schedule.size() > 0;
         if(play_state_sound) {
             this->prev_state = this->current_state();
@@ -16,7 +16,7 @@ namespace houseofatmos::world {
         CarriageNetwork(CarriageNetwork&& other) noexcept = default;
         CarriageNetwork& operator=(CarriageNetwork&& other) noexcept = default;
 
-        bool is_passable(NodeId node) override;
+        bool compute_passable(NodeId node) override;
 
     };
 
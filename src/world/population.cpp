@@ -162,6 +162,7 @@ namespace houseofatmos::world {
                 u64 z = building.z + ch_z * terrain.tiles_per_chunk();
                 if(x != rem_x || z != rem_z) { continue; }
                 chunk.buildings.erase(chunk.buildings.begin() + b);
+                terrain.reindex_chunk_buildings(ch_x, ch_z);
                 break;
             }
             p.houses.pop_back();
@@ -177,6 +177,7 @@ namespace houseofatmos::world {
         renderer.sun_direction = sun_direction;
         renderer.diffuse_min = settings.do_dithering? 0.0 : 1.0;
         renderer.diffuse_max = 1.0;
+        renderer.log_frame_stats = settings.log_render_stats;
     }
 
 
@@ -557,10 +558,13 @@ namespace houseofatmos::world {
             &this->interactables, window, this->world
         );
         this->world->terrain.spawn_particles(window, this->particles);
-        this->renderer.render_to_shadow_maps();
+        this->renderer.begin_recording();
         this->render_geometry(window);
+        this->renderer.end_recording();
+        this->renderer.render_to_shadow_maps();
+        this->renderer.replay();
         this->renderer.render_to_output();
-        this->render_geometry(window);
+        this->renderer.replay();
         this->world->terrain.render_water(*this, this->renderer, window);
         this->particles.render(this->renderer, *this, window);
         this->action_mode.render(window, *this, this->renderer);
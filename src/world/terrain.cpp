@@ -1,6 +1,7 @@
 
 #include "terrain.hpp"
 #include "../interior/scene.hpp"
+#include <engine/workers.hpp>
 
 namespace houseofatmos::world {
 
@@ -176,88 +177,348 @@ namespace houseofatmos::world {
         return u.cross(v).normalized();
     }
 
-    static u16 put_terrain_vertex(
-        const Vec<3>& pos, const Vec<2>& uv, const Vec<3>& normal,
+    // corners of a cell of the ground texture (bit 0 is U, bit 1 is V)
+    static const u8 uv_corner_bl = 0;
+    static const u8 uv_corner_br = 1;
+    static const u8 uv_corner_tl = 2;
+    static const u8 uv_corner_tr = 3;
+
+    // cells of the ground texture (bit 0 is U, bit 1 is V)
+    static const u8 uv_cell_sand = 0;
+    static const u8 uv_cell_path = 1;
+    static const u8 uv_cell_grass = 2;
+    static const u8 uv_cell_stone = 3;
+
+    // positions are relative to the chunk and always whole numbers,
+    // see 'Renderer::terrain_attribs' for the layout
+    static u32 put_terrain_vertex(
+        const Vec<3>& pos, u8 uv_corner, u8 uv_cell, const Vec<3>& normal,
         engine::Mesh& dest
     ) {
         dest.start_vertex();
-        dest.put_f32({ (f32) pos.x(), (f32) pos.y(), (f32) pos.z() });
-        dest.put_f32({ (f32) uv.x(), (f32) uv.y() });
-        dest.put_f32({ (f32) normal.x(), (f32) normal.y(), (f32) normal.z() });
-        dest.put_u8({ 0, 0, 0, 0 }); // joint indices
-        dest.put_f32({ 1, 0, 0, 0 }); // joint weights
+        dest.put_i16({ (i16) pos.x(), (i16) pos.y(), (i16) pos.z() });
+        dest.put_i8({ 
+            (i8) round(normal.x() * 127.0), 
+            (i8) round(normal.y() * 127.0), 
+            (i8) round(normal.z() * 127.0), 
+            0
+        });
+        dest.put_u8({ uv_corner, uv_cell });
         return dest.complete_vertex();
     }
 
     static void put_terrain_element_ccw(
         const Vec<3>& pos_a, const Vec<3>& pos_b, const Vec<3>& pos_c, 
-        const Vec<2>& uv_a, const Vec<2>& uv_b, const Vec<2>& uv_c,
+        u8 uv_a, u8 uv_b, u8 uv_c,
         bool is_path, engine::Mesh& dest
     ) {
         f64 min_height = std::min(pos_a.y(), std::min(pos_b.y(), pos_c.y()));
         f64 max_height = std::max(pos_a.y(), std::max(pos_b.y(), pos_c.y()));
         f64 height_diff = max_height - min_height;
-        Vec<2> uv_offset = is_path
-            ? Vec<2>(0.505, 0.000)
+        u8 uv_cell = is_path
+            ? uv_cell_path
             : min_height < sand_max_height
-            ? Vec<2>(0.000, 0.000)
+            ? uv_cell_sand
             : height_diff > stone_min_height_diff
-            ? Vec<2>(0.505, 0.505)
-            : Vec<2>(0.000, 0.505);
+            ? uv_cell_stone
+            : uv_cell_grass;
         Vec<3> normal = compute_normal_ccw(pos_a, pos_b, pos_c);
         dest.add_element(
-            put_terrain_vertex(pos_a, uv_a + uv_offset, normal, dest),
-            put_terrain_vertex(pos_b, uv_b + uv_offset, normal, dest),
-            put_terrain_vertex(pos_c, uv_c + uv_offset, normal, dest)
+            put_terrain_vertex(pos_a, uv_a, uv_cell, normal, dest),
+            put_terrain_vertex(pos_b, uv_b, uv_cell, normal, dest),
+            put_terrain_vertex(pos_c, uv_c, uv_cell, normal, dest)
         );
     }
 
+    // flags for each tile of a chunk snapshot
+    static const u8 snapshot_tile_building = 1 << 0;
+    static const u8 snapshot_tile_hides_ground = 1 << 1;
+
+    // edges of a chunk snapshot
+    static const u8 snapshot_edge_top = 1 << 0;
+    static const u8 snapshot_edge_right = 1 << 1;
+    static const u8 snapshot_edge_bottom = 1 << 2;
+    static const u8 snapshot_edge_left = 1 << 3;
+
+    // chunks further away from the viewer than these distances (in chunks)
+    // may have their terrain built with less detail
+    static const u64 full_detail_distance = 2;
+    static const u64 half_detail_distance = 4;
+    // largest difference in elevation (in units) between the terrain of a
+    // chunk with less detail and the actual terrain
+    static const f64 max_detail_error = 1.0;
+
+    f64 Terrain::chunk_detail_error(
+        i64 chunk_x, i64 chunk_z, u64 tile_step
+    ) const {
+        if(tile_step <= 1 || !this->chunk_in_bounds(chunk_x, chunk_z)) {
+            return 0.0;
+        }
+        u64 start_x = (u64) chunk_x * this->chunk_tiles;
+        u64 start_z = (u64) chunk_z * this->chunk_tiles;
+        u64 width = std::min(this->chunk_tiles, this->width - start_x);
+        u64 height = std::min(this->chunk_tiles, this->height - start_z);
+        f64 error = 0.0;
+        for(u64 left = 0; left < width; left += tile_step) {
+            u64 right = std::min(left + tile_step, width);
+            for(u64 top = 0; top < height; top += tile_step) {
+                u64 bottom = std::min(top + tile_step, height);
+                f64 tl = this->elevation_at(start_x + left, start_z + top);
+                f64 tr = this->elevation_at(start_x + right, start_z + top);
+                f64 bl = this->elevation_at(start_x + left, start_z + bottom);
+                f64 br = this->elevation_at(start_x + right, start_z + bottom);
+                // compare each corner covered by the quad to its surface
+                for(u64 x = left; x <= right; x += 1) {
+                    f64 u = (f64) (x - left) / (f64) (right - left);
+                    for(u64 z = top; z <= bottom; z += 1) {
+                        f64 v = (f64) (z - top) / (f64) (bottom - top);
+                        f64 surface = (tl * (1.0 - u) + tr * u) * (1.0 - v)
+                            + (bl * (1.0 - u) + br * u) * v;
+                        f64 actual = this->elevation_at(start_x + x, start_z + z);
+                        error = std::max(error, fabs(actual - surface));
+                    }
+                }
+            }
+        }
+        return error;
+    }
+
+    Terrain::ChunkDetail Terrain::chunk_detail(
+        i64 chunk_x, i64 chunk_z, u64 distance
+    ) const {
+        auto max_tile_step = [&](u64 distance) {
+            if(distance <= full_detail_distance) { return (u64) 1; }
+            if(distance <= half_detail_distance) { return (u64) 2; }
+            return this->chunk_tiles;
+        };
+        // use the largest step allowed at the distance that still
+        // keeps the relief of the chunk (hills, valleys, lakes)
+        u64 step = max_tile_step(distance);
+        while(step > 1) {
+            f64 error = this->chunk_detail_error(chunk_x, chunk_z, step);
+            if(error <= max_detail_error) { break; }
+            step /= 2;
+        }
+        // chunks with a neighbor that may use a different tile step need
+        // skirts, which neighbors further away than 'full_detail_distance' do
+        bool skirts = max_tile_step(distance + 1) != 1;
+        return ChunkDetail(step, skirts);
+    }
+
+    Terrain::ChunkSnapshot Terrain::snapshot_chunk(
+        i64 chunk_x, i64 chunk_z, ChunkDetail detail
+    ) const {
+        ChunkSnapshot snapshot;
+        snapshot.x = chunk_x;
+        snapshot.z = chunk_z;
+        snapshot.width = 0;
+        snapshot.height = 0;
+        snapshot.tile_size = this->tile_size;
+        snapshot.chunk_tiles = this->chunk_tiles;
+        snapshot.detail = detail;
+        snapshot.skirt_edges = 0;
+        if(!this->chunk_in_bounds(chunk_x, chunk_z)) { return snapshot; }
+        // edges at the end of the world don't border any other chunks
+        if(detail.skirts) {
+            if(chunk_z > 0) { snapshot.skirt_edges |= snapshot_edge_top; }
+            if(chunk_x > 0) { snapshot.skirt_edges |= snapshot_edge_left; }
+            if(chunk_x + 1 < (i64) this->width_chunks) {
+                snapshot.skirt_edges |= snapshot_edge_right;
+            }
+            if(chunk_z + 1 < (i64) this->height_chunks) {
+                snapshot.skirt_edges |= snapshot_edge_bottom;
+            }
+        }
+        u64 start_x = (u64) chunk_x * this->chunk_tiles;
+        u64 start_z = (u64) chunk_z * this->chunk_tiles;
+        snapshot.width = std::min(this->chunk_tiles, this->width - start_x);
+        snapshot.height = std::min(this->chunk_tiles, this->height - start_z);
+        snapshot.elevation.reserve((snapshot.width + 1) * (snapshot.height + 1));
+        for(u64 z = start_z; z <= start_z + snapshot.height; z += 1) {
+            auto row = this->elevation.begin() + (start_x + (this->width + 1) * z);
+            snapshot.elevation.insert(
+                snapshot.elevation.end(), row, row + snapshot.width + 1
+            );
+        }
+        snapshot.building_tiles.resize(snapshot.width * snapshot.height);
+        for(u64 rel_z = 0; rel_z < snapshot.height; rel_z += 1) {
+            for(u64 rel_x = 0; rel_x < snapshot.width; rel_x += 1) {
+                const Building* building = this->building_at(
+                    (i64) (start_x + rel_x), (i64) (start_z + rel_z)
+                );
+                if(building == nullptr) { continue; }
+                u8 flags = snapshot_tile_building;
+                if(!building->get_type_info().terrain_under_building) {
+                    flags |= snapshot_tile_hides_ground;
+                }
+                snapshot.building_tiles[rel_x + rel_z * snapshot.width] = flags;
+            }
+        }
+        snapshot.data = this->chunk_at((u64) chunk_x, (u64) chunk_z);
+        return snapshot;
+    }
+
+    static const Terrain::ChunkDetail full_chunk_detail 
+        = Terrain::ChunkDetail(1, false);
+
     engine::Mesh Terrain::build_chunk_terrain_geometry(u64 chunk_x, u64 chunk_z) const {
-        auto geometry = engine::Mesh(Renderer::mesh_attribs);
-        const ChunkData& chunk_data = this->chunk_at(chunk_x, chunk_z);
-        u64 start_x = chunk_x * this->chunk_tiles;
-        u64 end_x = std::min((chunk_x + 1) * this->chunk_tiles, this->width);
-        u64 start_z = chunk_z * this->chunk_tiles;
-        u64 end_z = std::min((chunk_z + 1) * this->chunk_tiles, this->height);
-        for(u64 x = start_x; x < end_x; x += 1) {
-            for(u64 z = start_z; z < end_z; z += 1) {
-                const Building* building = this->building_at((i64) x, (i64) z);
-                bool skip_tile = building != nullptr
-                    && !building->get_type_info().terrain_under_building;
-                if(skip_tile) { continue; }
-                u64 left = x - start_x;
-                u64 right = left + 1;
-                u64 top = z - start_z;
-                u64 bottom = top + 1;
+        auto geometry = engine::Mesh(Renderer::terrain_attribs);
+        Terrain::build_chunk_terrain_geometry(
+            this->snapshot_chunk((i64) chunk_x, (i64) chunk_z, full_chunk_detail), 
+            geometry
+        );
+        geometry.submit();
+        return geometry;
+    }
+
+    static bool snapshot_area_hides_ground(
+        const Terrain::ChunkSnapshot& snapshot, 
+        u64 left, u64 top, u64 right, u64 bottom
+    ) {
+        for(u64 x = left; x < right; x += 1) {
+            for(u64 z = top; z < bottom; z += 1) {
+                u8 building = snapshot.building_tiles[x + z * snapshot.width];
+                if(!(building & snapshot_tile_hides_ground)) { return false; }
+            }
+        }
+        return true;
+    }
+
+    // larger quads are only drawn as paths if most tiles they cover are
+    static bool snapshot_area_is_path(
+        const Terrain::ChunkData& chunk_data, 
+        u64 left, u64 top, u64 right, u64 bottom
+    ) {
+        u64 paths = 0;
+        for(u64 x = left; x < right; x += 1) {
+            for(u64 z = top; z < bottom; z += 1) {
+                if(chunk_data.path_at(x, z)) { paths += 1; }
+            }
+        }
+        return paths * 2 > (right - left) * (bottom - top);
+    }
+
+    static void put_terrain_skirt_ccw(
+        const Vec<3>& pos_a, const Vec<3>& pos_b, f64 bottom_y, 
+        engine::Mesh& dest
+    ) {
+        Vec<3> pos_a_bottom = Vec<3>(pos_a.x(), bottom_y, pos_a.z());
+        Vec<3> pos_b_bottom = Vec<3>(pos_b.x(), bottom_y, pos_b.z());
+        u8 uv_top = uv_corner_tl;
+        u8 uv_bottom = uv_corner_bl;
+        put_terrain_element_ccw(
+            pos_a, pos_b, pos_a_bottom, uv_top, uv_top, uv_bottom, false, dest
+        );
+        put_terrain_element_ccw(
+            pos_b, pos_b_bottom, pos_a_bottom, 
+            uv_top, uv_bottom, uv_bottom, false, dest
+        );
+    }
+
+    // Skirts are walls going down from the edges of a chunk, which hide
+    // the gaps between chunks of different detail. They go down to the
+    // lowest point on the chunk edges, which is always low enough to reach
+    // the edge of any neighbor.
+    static void build_chunk_skirts(
+        const Terrain::ChunkSnapshot& snapshot, engine::Mesh& geometry
+    ) {
+        u64 step = snapshot.detail.tile_step;
+        f64 tile_size = (f64) snapshot.tile_size;
+        auto corner = [&](u64 x, u64 z) {
+            return Vec<3>(
+                x * tile_size, snapshot.elevation_at(x, z), z * tile_size
+            );
+        };
+        f64 bottom_y = INFINITY;
+        for(u64 x = 0; x <= snapshot.width; x += 1) {
+            bottom_y = std::min(bottom_y, (f64) snapshot.elevation_at(x, 0));
+            bottom_y = std::min(
+                bottom_y, (f64) snapshot.elevation_at(x, snapshot.height)
+            );
+        }
+        for(u64 z = 0; z <= snapshot.height; z += 1) {
+            bottom_y = std::min(bottom_y, (f64) snapshot.elevation_at(0, z));
+            bottom_y = std::min(
+                bottom_y, (f64) snapshot.elevation_at(snapshot.width, z)
+            );
+        }
+        bottom_y -= 1.0;
+        // each edge is walked clockwise so that the skirts face outwards
+        for(u64 left = 0; left < snapshot.width; left += step) {
+            u64 right = std::min(left + step, snapshot.width);
+            if(snapshot.skirt_edges & snapshot_edge_top) {
+                put_terrain_skirt_ccw(
+                    corner(left, 0), corner(right, 0), bottom_y, geometry
+                );
+            }
+            if(snapshot.skirt_edges & snapshot_edge_bottom) {
+                put_terrain_skirt_ccw(
+                    corner(right, snapshot.height), 
+                    corner(left, snapshot.height), 
+                    bottom_y, geometry
+                );
+            }
+        }
+        for(u64 top = 0; top < snapshot.height; top += step) {
+            u64 bottom = std::min(top + step, snapshot.height);
+            if(snapshot.skirt_edges & snapshot_edge_right) {
+                put_terrain_skirt_ccw(
+                    corner(snapshot.width, top), 
+                    corner(snapshot.width, bottom), 
+                    bottom_y, geometry
+                );
+            }
+            if(snapshot.skirt_edges & snapshot_edge_left) {
+                put_terrain_skirt_ccw(
+                    corner(0, bottom), corner(0, top), bottom_y, geometry
+                );
+            }
+        }
+    }
+
+    void Terrain::build_chunk_terrain_geometry(
+        const ChunkSnapshot& snapshot, engine::Mesh& geometry
+    ) {
+        geometry.clear();
+        if(!snapshot.data.has_value()) { return; }
+        const ChunkData& chunk_data = *snapshot.data;
+        f32 tile_size = (f32) snapshot.tile_size;
+        u64 step = snapshot.detail.tile_step;
+        for(u64 left = 0; left < snapshot.width; left += step) {
+            u64 right = std::min(left + step, snapshot.width);
+            for(u64 top = 0; top < snapshot.height; top += step) {
+                u64 bottom = std::min(top + step, snapshot.height);
+                bool hides_ground = snapshot_area_hides_ground(
+                    snapshot, left, top, right, bottom
+                );
+                if(hides_ground) { continue; }
                 Vec<3> pos_tl = {
-                    (f32) left * this->tile_size, 
-                    (f32) this->elevation_at(x, z), 
-                    (f32) top * this->tile_size 
+                    (f32) left * tile_size, 
+                    (f32) snapshot.elevation_at(left, top), 
+                    (f32) top * tile_size 
                 };
                 Vec<3> pos_tr = {
-                    (f32) right * this->tile_size, 
-                    (f32) this->elevation_at(x + 1, z), 
-                    (f32) top * this->tile_size
+                    (f32) right * tile_size, 
+                    (f32) snapshot.elevation_at(right, top), 
+                    (f32) top * tile_size
                 };
                 Vec<3> pos_bl = {
-                    (f32) left * this->tile_size, 
-                    (f32) this->elevation_at(x, z + 1), 
-                    (f32) bottom * this->tile_size
+                    (f32) left * tile_size, 
+                    (f32) snapshot.elevation_at(left, bottom), 
+                    (f32) bottom * tile_size
                 };
                 Vec<3> pos_br = {
-                    (f32) right * this->tile_size,
-                    (f32) this->elevation_at(x + 1, z + 1),
-                    (f32) bottom * this->tile_size
+                    (f32) right * tile_size,
+                    (f32) snapshot.elevation_at(right, bottom),
+                    (f32) bottom * tile_size
                 };
                 f64 tl_br_height_diff = fabs(pos_tl.y() - pos_br.y());
                 f64 tr_bl_height_diff = fabs(pos_tr.y() - pos_bl.y());
                 f64 tl_br_height_max = std::max(pos_tl.y(), pos_br.y());
                 f64 tr_bl_height_max = std::max(pos_tr.y(), pos_bl.y());
-                bool is_path = chunk_data.path_at(left, top);
-                Vec<2> uv_bl = { 0.00, 0.00 };
-                Vec<2> uv_br = { 0.49, 0.00 };
-                Vec<2> uv_tl = { 0.00, 0.49 };
-                Vec<2> uv_tr = { 0.49, 0.49 };
+                bool is_path = snapshot_area_is_path(
+                    chunk_data, left, top, right, bottom
+                );
                 bool cut_tl_br = tl_br_height_diff == tr_bl_height_diff
                     ? tl_br_height_max < tr_bl_height_max
                     : tl_br_height_diff < tr_bl_height_diff;
@@ -267,12 +528,12 @@ namespace houseofatmos::world {
                     // bl---br
                     put_terrain_element_ccw(
                         pos_tl, pos_bl, pos_br, 
-                        uv_tl, uv_bl, uv_br, 
+                        uv_corner_tl, uv_corner_bl, uv_corner_br, 
                         is_path, geometry
                     );
                     put_terrain_element_ccw(
                         pos_tl, pos_br, pos_tr, 
-                        uv_tl, uv_br, uv_tr, 
+                        uv_corner_tl, uv_corner_br, uv_corner_tr, 
                         is_path, geometry
                     );
                 } else {
@@ -281,83 +542,85 @@ namespace houseofatmos::world {
                     // bl---br
                     put_terrain_element_ccw(
                         pos_tl, pos_bl, pos_tr, 
-                        uv_tl, uv_bl, uv_tr, 
+                        uv_corner_tl, uv_corner_bl, uv_corner_tr, 
                         is_path, geometry
                     );
                     put_terrain_element_ccw(
                         pos_tr, pos_bl, pos_br, 
-                        uv_tr, uv_bl, uv_br, 
+                        uv_corner_tr, uv_corner_bl, uv_corner_br, 
                         is_path, geometry
                     );
                 }
             }
         }
-        geometry.submit();
-        return geometry;
+        if(snapshot.skirt_edges != 0) { build_chunk_skirts(snapshot, geometry); }
     }
 
     engine::Mesh Terrain::build_chunk_water_geometry(i64 chunk_x, i64 chunk_z) const {
         auto geometry = engine::Mesh(Terrain::water_plane_attribs);
-        i64 start_x = chunk_x * (i64) this->chunk_tiles;
-        i64 end_x = (chunk_x + 1) * (i64) this->chunk_tiles;
-        i64 start_z = chunk_z * this->chunk_tiles;
-        i64 end_z = (chunk_z + 1) * (i64) this->chunk_tiles;
-        for(i64 x = start_x; x < end_x; x += 1) {
-            for(i64 z = start_z; z < end_z; z += 1) {
-                i64 abs_t_left = x;
-                i64 abs_t_right = abs_t_left + 1;
-                i64 abs_t_top = z;
-                i64 abs_t_bottom = abs_t_top + 1;
-                bool in_bounds = x >= 0 && z >= 0
-                    && x < (i64) this->width_in_tiles() 
-                    && z < (i64) this->width_in_tiles();
+        Terrain::build_chunk_water_geometry(
+            this->snapshot_chunk(chunk_x, chunk_z, full_chunk_detail), geometry
+        );
+        geometry.submit();
+        return geometry;
+    }
+
+    static bool snapshot_area_has_water(
+        const Terrain::ChunkSnapshot& snapshot, 
+        u64 left, u64 top, u64 right, u64 bottom
+    ) {
+        for(u64 x = left; x < right; x += 1) {
+            for(u64 z = top; z < bottom; z += 1) {
+                bool in_bounds = x < snapshot.width && z < snapshot.height;
                 bool has_water = !in_bounds
-                    || this->elevation_at(abs_t_left, abs_t_top) < 0.0
-                    || this->elevation_at(abs_t_right, abs_t_top) < 0.0
-                    || this->elevation_at(abs_t_left, abs_t_bottom) < 0.0
-                    || this->elevation_at(abs_t_right, abs_t_bottom) < 0.0;
+                    || snapshot.elevation_at(x, z) < 0.0
+                    || snapshot.elevation_at(x + 1, z) < 0.0
+                    || snapshot.elevation_at(x, z + 1) < 0.0
+                    || snapshot.elevation_at(x + 1, z + 1) < 0.0;
+                if(has_water) { return true; }
+            }
+        }
+        return false;
+    }
+
+    void Terrain::build_chunk_water_geometry(
+        const ChunkSnapshot& snapshot, engine::Mesh& geometry
+    ) {
+        geometry.clear();
+        // water is a flat plane below the terrain, meaning that water quads
+        // of less detailed chunks may also cover tiles without water
+        u64 step = snapshot.detail.tile_step;
+        for(u64 left = 0; left < snapshot.chunk_tiles; left += step) {
+            u64 right = std::min(left + step, snapshot.chunk_tiles);
+            for(u64 top = 0; top < snapshot.chunk_tiles; top += step) {
+                u64 bottom = std::min(top + step, snapshot.chunk_tiles);
+                bool has_water = snapshot_area_has_water(
+                    snapshot, left, top, right, bottom
+                );
                 if(!has_water) { continue; }
-                f32 rel_u_left = (f32) ((abs_t_left - start_x) * this->tile_size);
-                f32 rel_u_right = (f32) ((abs_t_right - start_x) * this->tile_size);
-                f32 rel_u_top = (f32) ((abs_t_top - start_z) * this->tile_size);
-                f32 rel_u_bottom = (f32) ((abs_t_bottom - start_z) * this->tile_size);
+                f32 rel_u_left = (f32) (left * snapshot.tile_size);
+                f32 rel_u_right = (f32) (right * snapshot.tile_size);
+                f32 rel_u_top = (f32) (top * snapshot.tile_size);
+                f32 rel_u_bottom = (f32) (bottom * snapshot.tile_size);
                 // tl---tr
                 //  | \ |
                 // bl---br
                 geometry.start_vertex();
                     geometry.put_f32({ rel_u_left, water_height, rel_u_top });
-                u16 tl = geometry.complete_vertex();
+                u32 tl = geometry.complete_vertex();
                 geometry.start_vertex();
                     geometry.put_f32({ rel_u_right, water_height, rel_u_top });
-                u16 tr = geometry.complete_vertex();
+                u32 tr = geometry.complete_vertex();
                 geometry.start_vertex();
                     geometry.put_f32({ rel_u_left, water_height, rel_u_bottom });
-                u16 bl = geometry.complete_vertex();
+                u32 bl = geometry.complete_vertex();
                 geometry.start_vertex();
                     geometry.put_f32({ rel_u_right, water_height, rel_u_bottom });
-                u16 br = geometry.complete_vertex();
+                u32 br = geometry.complete_vertex();
                 geometry.add_element(tl, bl, br);
                 geometry.add_element(tl, br, tr);
             }
         }
-        geometry.submit();
-        return geometry;
-    }
-
-    std::unordered_map<Foliage::Type, std::vector<Mat<4>>>
-        Terrain::collect_foliage_transforms(u64 chunk_x, u64 chunk_z) const {
-        std::unordered_map<Foliage::Type, std::vector<Mat<4>>> instances;
-        const ChunkData& chunk_data = this->chunk_at(chunk_x, chunk_z);
-        Vec<3> chunk_offset = Vec<3>(chunk_x, 0, chunk_z)
-            * this->chunk_tiles * this->tile_size;
-        for(const Foliage& foliage: chunk_data.foliage) {
-            Vec<3> offset = chunk_offset
-                + Vec<3>(foliage.x, foliage.y, foliage.z);
-            Mat<4> instance = Mat<4>::translate(offset)
-                * Mat<4>::rotate_y(foliage.rotation);
-            instances[foliage.type].push_back(instance);
-        }
-        return instances;
     }
 
     Mat<4> Terrain::building_transform(
@@ -377,53 +640,91 @@ namespace houseofatmos::world {
         return Mat<4>::translate(offset);
     }
 
-    std::unordered_map<Building::Type, std::vector<Mat<4>>>
-        Terrain::collect_building_transforms(u64 chunk_x, u64 chunk_z) const {
-        std::unordered_map<Building::Type, std::vector<Mat<4>>> instances;
-        const ChunkData& chunk_data = this->chunk_at(chunk_x, chunk_z);
-        for(const Building& building: chunk_data.buildings) {
-            Mat<4> inst = this->building_transform(building, chunk_x, chunk_z);
-            instances[building.type].push_back(inst);
-        }
-        return instances;
+    Mat<4> Terrain::building_transform(
+        const Building& building, const ChunkSnapshot& snapshot
+    ) {
+        const Building::TypeInfo& type = building.get_type_info(); 
+        Vec<3> chunk_offset_tiles = Vec<3>(snapshot.x, 0, snapshot.z)
+            * snapshot.chunk_tiles;
+        Vec<3> relative_offset_tiles = Vec<3>(building.x, 0, building.z) 
+            + Vec<3>(type.width / 2.0, 0, type.height / 2.0);
+        Vec<3> offset = (chunk_offset_tiles + relative_offset_tiles)
+            * snapshot.tile_size;
+        offset.y() = snapshot.elevation_at(building.x, building.z);
+        return Mat<4>::translate(offset);
     }
 
-    std::unordered_map<Resource::Type, std::vector<Mat<4>>>
-        Terrain::collect_resource_transforms(u64 chunk_x, u64 chunk_z) const {
-        std::unordered_map<Resource::Type, std::vector<Mat<4>>> instances;
-        const ChunkData& chunk_data = this->chunk_at(chunk_x, chunk_z);
-        u64 chunk_t_x = chunk_x * this->tiles_per_chunk();
-        u64 chunk_t_z = chunk_z * this->tiles_per_chunk();
-        for(const Resource& resource: chunk_data.resources) {
-            u64 left = chunk_t_x + resource.x;
-            u64 top = chunk_t_z + resource.z;
-            u64 right = left + 1;
-            u64 bottom = top + 1;
-            if(chunk_data.path_at(resource.x, resource.z)) { continue; }
-            if(this->building_at((i64) left, (i64) top)) { continue; }
-            i64 elev = this->elevation_at(left, top);
-            if(elev != this->elevation_at(right, top)) { continue; }
-            if(elev != this->elevation_at(left, bottom)) { continue; }
-            if(elev != this->elevation_at(right, bottom)) { continue; }
-            Vec<3> offset = Vec<3>(left + 0.5, 0, top + 0.5) 
-                * this->units_per_tile();
-            offset.y() = elev;
-            Mat<4> inst = Mat<4>::translate(offset);
-            instances[resource.type].push_back(inst);
+    void Terrain::build_chunk(
+        const ChunkSnapshot& snapshot, u16 parts, LoadedChunk& loaded
+    ) {
+        loaded.x = snapshot.x;
+        loaded.z = snapshot.z;
+        loaded.modified = 0;
+        loaded.hidden = false;
+        loaded.detail = snapshot.detail;
+        if(parts & ChunkWater) {
+            Terrain::build_chunk_water_geometry(snapshot, loaded.water);
         }
-        return instances;
-    }
-
-    std::unordered_map<TrackPiece::Type, std::vector<Mat<4>>>
-    Terrain::collect_track_piece_transforms(u64 chunk_x, u64 chunk_z) const {
-        std::unordered_map<TrackPiece::Type, std::vector<Mat<4>>> instances;
-        const ChunkData& chunk_data = this->chunk_at(chunk_x, chunk_z);
-        for(const TrackPiece& track_piece: chunk_data.track_pieces) {
-            instances[track_piece.type].push_back(track_piece.build_transform(
-                chunk_x, chunk_z, this->tiles_per_chunk(), this->units_per_tile()
-            ));
+        if(parts & ChunkGround) {
+            Terrain::build_chunk_terrain_geometry(snapshot, loaded.terrain);
+            // skirts never go below the lowest elevation of the chunk
+            auto [min_elev, max_elev] = std::minmax_element(
+                snapshot.elevation.begin(), snapshot.elevation.end()
+            );
+            bool empty = snapshot.elevation.size() == 0;
+            loaded.min_elevation = empty? 0 : *min_elev;
+            loaded.max_elevation = empty? 0 : *max_elev;
+        }
+        if(!snapshot.data.has_value()) { return; }
+        const ChunkData& chunk_data = *snapshot.data;
+        Vec<3> chunk_offset = Vec<3>(snapshot.x, 0, snapshot.z)
+            * snapshot.chunk_tiles * snapshot.tile_size;
+        if(parts & ChunkFoliage) {
+            for(const Foliage& foliage: chunk_data.foliage) {
+                Vec<3> offset = chunk_offset
+                    + Vec<3>(foliage.x, foliage.y, foliage.z);
+                Mat<4> instance = Mat<4>::translate(offset)
+                    * Mat<4>::rotate_y(foliage.rotation);
+                loaded.foliage[foliage.type].push_back(instance);
+            }
+        }
+        if(parts & ChunkBuildings) {
+            for(const Building& building: chunk_data.buildings) {
+                Mat<4> inst = Terrain::building_transform(building, snapshot);
+                loaded.buildings[building.type].push_back(inst);
+            }
+        }
+        if(parts & ChunkResources) {
+            for(const Resource& resource: chunk_data.resources) {
+                u64 left = resource.x;
+                u64 top = resource.z;
+                u64 right = left + 1;
+                u64 bottom = top + 1;
+                if(chunk_data.path_at(left, top)) { continue; }
+                u8 building = snapshot.building_tiles
+                    [left + top * snapshot.width];
+                if(building & snapshot_tile_building) { continue; }
+                i64 elev = snapshot.elevation_at(left, top);
+                if(elev != snapshot.elevation_at(right, top)) { continue; }
+                if(elev != snapshot.elevation_at(left, bottom)) { continue; }
+                if(elev != snapshot.elevation_at(right, bottom)) { continue; }
+                Vec<3> offset = chunk_offset
+                    + Vec<3>(left + 0.5, 0, top + 0.5) * snapshot.tile_size;
+                offset.y() = elev;
+                Mat<4> inst = Mat<4>::translate(offset);
+                loaded.resources[resource.type].push_back(inst);
+            }
+        }
+        if(parts & ChunkTrack) {
+            for(const TrackPiece& track_piece: chunk_data.track_pieces) {
+                loaded.track_pieces[track_piece.type].push_back(
+                    track_piece.build_transform(
+                        (u64) snapshot.x, (u64) snapshot.z, 
+                        snapshot.chunk_tiles, snapshot.tile_size
+                    )
+                );
+            }
         }
-        return instances;
     }
 
     std::vector<std::shared_ptr<Interactable>> Terrain::create_chunk_interactables(
@@ -492,40 +793,285 @@ namespace houseofatmos::world {
         return spawners;
     }
 
-    Terrain::LoadedChunk Terrain::load_chunk(
-        i64 chunk_x, i64 chunk_z, 
+    Terrain::ChunkBuild::ChunkBuild(ChunkSnapshot&& snapshot, u16 parts): 
+        snapshot(std::move(snapshot)), 
+        parts(parts),
+        chunk({
+            this->snapshot.x, this->snapshot.z, 0, false, this->snapshot.detail,
+            engine::Mesh(Renderer::terrain_attribs), 0, 0,
+            engine::Mesh(Terrain::water_plane_attribs),
+            std::unordered_map<Foliage::Type, std::vector<Mat<4>>>(),
+            std::unordered_map<Building::Type, std::vector<Mat<4>>>(),
+            std::unordered_map<Resource::Type, std::vector<Mat<4>>>(),
+            std::unordered_map<TrackPiece::Type, std::vector<Mat<4>>>(),
+            std::vector<std::shared_ptr<Interactable>>(),
+            std::vector<ParticleSpawner>()
+        }) {}
+
+    Terrain::ChunkBuild::ChunkBuild(LoadedChunk&& chunk):
+        parts(AllChunkParts), chunk(std::move(chunk)) {
+        this->snapshot.x = this->chunk.x;
+        this->snapshot.z = this->chunk.z;
+        this->snapshot.width = 0;
+        this->snapshot.height = 0;
+        this->snapshot.tile_size = 0;
+        this->snapshot.chunk_tiles = 0;
+        this->snapshot.detail = this->chunk.detail;
+        this->snapshot.skirt_edges = 0;
+        this->completed = true;
+    }
+
+    void Terrain::reload_chunk_at(u64 chunk_x, u64 chunk_z, u16 parts) {
+        auto chunk = this->loaded_chunk_at((i64) chunk_x, (i64) chunk_z);
+        if(chunk != nullptr) { chunk->modified |= parts; }
+        this->chunk_cache.remove_if([&](const auto& build) {
+            return build->snapshot.x == (i64) chunk_x
+                && build->snapshot.z == (i64) chunk_z;
+        });
+        if(this->chunk_slots_size == 0) { return; }
+        std::shared_ptr<ChunkBuild>& build = this->chunk_builds
+            [this->chunk_slot_index((i64) chunk_x, (i64) chunk_z)];
+        if(build == nullptr) { return; }
+        if(build->snapshot.x != (i64) chunk_x) { return; }
+        if(build->snapshot.z != (i64) chunk_z) { return; }
+        build->outdated = true;
+    }
+
+    void Terrain::reload_area(
+        i64 min_x, i64 min_z, i64 max_x, i64 max_z, u16 parts
+    ) {
+        if(max_x < 0 || max_z < 0) { return; }
+        u64 min_ch_x = (u64) std::max(min_x, (i64) 0) / this->chunk_tiles;
+        u64 min_ch_z = (u64) std::max(min_z, (i64) 0) / this->chunk_tiles;
+        u64 max_ch_x = std::min(
+            (u64) max_x / this->chunk_tiles, this->width_chunks - 1
+        );
+        u64 max_ch_z = std::min(
+            (u64) max_z / this->chunk_tiles, this->height_chunks - 1
+        );
+        for(u64 ch_x = min_ch_x; ch_x <= max_ch_x; ch_x += 1) {
+            for(u64 ch_z = min_ch_z; ch_z <= max_ch_z; ch_z += 1) {
+                this->reload_chunk_at(ch_x, ch_z, parts);
+            }
+        }
+    }
+
+    // Parts of the chunk in the slot that the discarded build was going to
+    // rebuild still need to be - if the replacing build is for the same chunk
+    // they are returned, otherwise they are marked as modified in the slot.
+    u16 Terrain::discard_chunk_build(size_t slot_i, i64 chunk_x, i64 chunk_z) {
+        const std::shared_ptr<ChunkBuild>& prev = this->chunk_builds[slot_i];
+        std::optional<LoadedChunk>& slot = this->chunk_slots[slot_i];
+        bool prev_rebuilds_slot = prev != nullptr && slot.has_value()
+            && prev->snapshot.x == slot->x && prev->snapshot.z == slot->z;
+        if(!prev_rebuilds_slot) { return 0; }
+        bool restarted = prev->snapshot.x == chunk_x
+            && prev->snapshot.z == chunk_z;
+        if(restarted) { return prev->parts; }
+        slot->modified |= prev->parts;
+        return 0;
+    }
+
+    void Terrain::start_chunk_build(
+        size_t slot_i, i64 chunk_x, i64 chunk_z, ChunkDetail detail, u16 parts
+    ) {
+        parts |= this->discard_chunk_build(slot_i, chunk_x, chunk_z);
+        auto build = std::make_shared<ChunkBuild>(
+            this->snapshot_chunk(chunk_x, chunk_z, detail), parts
+        );
+        this->chunk_builds[slot_i] = build;
+        engine::WorkerPool::shared().submit([build]() {
+            Terrain::build_chunk(build->snapshot, build->parts, build->chunk);
+            build->completed = true;
+        });
+    }
+
+    bool Terrain::finish_chunk_build(
+        size_t slot_i, 
         Interactables* interactables, engine::Window& window,
-        const std::shared_ptr<World>& world,
-        bool in_bounds
+        const std::shared_ptr<World>& world
     ) {
-        if(!in_bounds) {
-            return {
-                chunk_x, chunk_z, false,
-                engine::Mesh(Renderer::mesh_attribs),
-                this->build_chunk_water_geometry(chunk_x, chunk_z),
-                std::unordered_map<Foliage::Type, std::vector<Mat<4>>>(),
-                std::unordered_map<Building::Type, std::vector<Mat<4>>>(),
-                std::unordered_map<Resource::Type, std::vector<Mat<4>>>(),
-                std::unordered_map<TrackPiece::Type, std::vector<Mat<4>>>(),
-                std::vector<std::shared_ptr<Interactable>>(),
-                std::vector<ParticleSpawner>()
-            };
+        std::shared_ptr<ChunkBuild>& build = this->chunk_builds[slot_i];
+        if(build == nullptr || !build->completed) { return false; }
+        LoadedChunk& built = build->chunk;
+        u16 parts = build->parts;
+        std::optional<LoadedChunk>& slot = this->chunk_slots[slot_i];
+        bool replaced = !slot.has_value()
+            || slot->x != built.x || slot->z != built.z;
+        if(replaced) {
+            bool cached = slot.has_value() && slot->modified == 0;
+            if(cached) {
+                slot->interactables.clear();
+                slot->particle_spawners.clear();
+                this->cache_chunk(std::make_shared<ChunkBuild>(std::move(*slot)));
+            }
+            // chunks that don't get cached pass their buffers on
+            if(slot.has_value() && !cached) {
+                slot->terrain.replace_data(std::move(built.terrain));
+                slot->water.replace_data(std::move(built.water));
+                built.terrain = std::move(slot->terrain);
+                built.water = std::move(slot->water);
+            }
+            slot = std::move(built);
+            slot->hidden = false;
+            parts = AllChunkParts;
+        } else {
+            if(parts & ChunkGround) { 
+                slot->terrain.replace_data(std::move(built.terrain)); 
+                slot->min_elevation = built.min_elevation;
+                slot->max_elevation = built.max_elevation;
+            }
+            if(parts & ChunkWater) { 
+                slot->water.replace_data(std::move(built.water)); 
+            }
+            if(parts & (ChunkGround | ChunkWater)) { 
+                slot->detail = built.detail; 
+            }
+            if(parts & ChunkFoliage) { slot->foliage = std::move(built.foliage); }
+            if(parts & ChunkBuildings) { 
+                slot->buildings = std::move(built.buildings); 
+            }
+            if(parts & ChunkResources) { 
+                slot->resources = std::move(built.resources); 
+            }
+            if(parts & ChunkTrack) {
+                slot->track_pieces = std::move(built.track_pieces);
+            }
+        }
+        build = nullptr;
+        this->update_slot_instances(slot_i, parts);
+        LoadedChunk& loaded = *slot;
+        if(parts & ChunkGround) { loaded.terrain.submit(); }
+        if(parts & ChunkWater) { loaded.water.submit(); }
+        // interactables and particle spawners need the live world state,
+        // which is fine to access since the snapshot is still up to date
+        if(!this->chunk_in_bounds(loaded.x, loaded.z)) { return true; }
+        u64 c_x = (u64) loaded.x;
+        u64 c_z = (u64) loaded.z;
+        if(parts & ChunkInteractables) {
+            loaded.interactables = this->create_chunk_interactables(
+                c_x, c_z, interactables, window, world
+            );
+        }
+        if(parts & ChunkSpawners) {
+            loaded.particle_spawners = this
+                ->create_chunk_particle_spawners(c_x, c_z);
+        }
+        return true;
+    }
+
+    // maximum number of chunks kept in the chunk cache
+    static const size_t chunk_cache_size = 64;
+
+    std::shared_ptr<Terrain::ChunkBuild> Terrain::take_cached_chunk(
+        i64 chunk_x, i64 chunk_z
+    ) {
+        auto cached = std::find_if(
+            this->chunk_cache.begin(), this->chunk_cache.end(),
+            [&](const auto& build) {
+                return build->snapshot.x == chunk_x 
+                    && build->snapshot.z == chunk_z;
+            }
+        );
+        if(cached == this->chunk_cache.end()) { return nullptr; }
+        std::shared_ptr<ChunkBuild> taken = std::move(*cached);
+        this->chunk_cache.erase(cached);
+        return taken;
+    }
+
+    void Terrain::cache_chunk(std::shared_ptr<ChunkBuild>&& build) {
+        this->chunk_cache.push_front(std::move(build));
+        if(this->chunk_cache.size() > chunk_cache_size) {
+            this->chunk_cache.pop_back();
+        }
+    }
+
+    // maximum number of chunk builds started ahead of time each frame
+    static const u64 max_chunk_prefetches = 2;
+    // how many seconds of travel ahead of the viewer chunks get built
+    static const f64 chunk_prefetch_time = 3.0;
+
+    void Terrain::prefetch_chunk(
+        i64 chunk_x, i64 chunk_z, ChunkDetail detail, u64& started_builds
+    ) {
+        std::shared_ptr<ChunkBuild> cached 
+            = this->take_cached_chunk(chunk_x, chunk_z);
+        if(cached != nullptr) {
+            this->cache_chunk(std::move(cached));
+            return;
+        }
+        if(started_builds >= max_chunk_prefetches) { return; }
+        auto build = std::make_shared<ChunkBuild>(
+            this->snapshot_chunk(chunk_x, chunk_z, detail), AllChunkParts
+        );
+        engine::WorkerPool::shared().submit([build]() {
+            Terrain::build_chunk(build->snapshot, build->parts, build->chunk);
+            build->completed = true;
+        });
+        this->cache_chunk(std::move(build));
+        started_builds += 1;
+    }
+
+    void Terrain::prefetch_chunks(
+        const Vec<3>& position, u64 draw_distance, 
+        const engine::Window& window
+    ) {
+        std::optional<Vec<3>> last_position = this->last_view_position;
+        this->last_view_position = position;
+        if(!last_position.has_value() || window.delta_time() <= 0.0) { return; }
+        // The velocity is derived from the viewed position, which covers
+        // walking, riding and being on board of a vehicle all the same.
+        Vec<3> velocity = (position - *last_position) / window.delta_time();
+        f64 chunk_size = (f64) (this->chunk_tiles * this->tile_size);
+        Vec<3> ahead = velocity * chunk_prefetch_time;
+        ahead.y() = 0.0;
+        f64 ahead_dist = ahead.len();
+        if(ahead_dist < chunk_size) { return; }
+        // also prevents teleports from building large amounts of chunks
+        f64 max_ahead_dist = (f64) draw_distance * chunk_size;
+        if(ahead_dist > max_ahead_dist) {
+            ahead = ahead * (max_ahead_dist / ahead_dist);
+            ahead_dist = max_ahead_dist;
+        }
+        // Move the draw distance along the direction of travel one chunk at
+        // a time, prefetching the chunks it newly covers at each step.
+        i64 prev_x = this->view_chunk_x;
+        i64 prev_z = this->view_chunk_z;
+        u64 step_count = (u64) (ahead_dist / chunk_size);
+        u64 started_builds = 0;
+        u64 visited_chunks = 0;
+        for(u64 step = 1; step <= step_count; step += 1) {
+            Vec<3> at = position + ahead * ((f64) step / (f64) step_count);
+            i64 center_x = (i64) floor(at.x() / chunk_size);
+            i64 center_z = (i64) floor(at.z() / chunk_size);
+            i64 dist = (i64) draw_distance;
+            for(i64 chunk_x = center_x - dist; chunk_x <= center_x + dist; chunk_x += 1) {
+                for(i64 chunk_z = center_z - dist; chunk_z <= center_z + dist; chunk_z += 1) {
+                    i64 prev_dist = std::max(
+                        llabs(chunk_x - prev_x), llabs(chunk_z - prev_z)
+                    );
+                    if(prev_dist <= dist) { continue; }
+                    if(!this->chunk_in_bounds(chunk_x, chunk_z)) { continue; }
+                    // leave room for chunks that left the draw distance
+                    if(visited_chunks >= chunk_cache_size / 2) { return; }
+                    // prefetched chunks enter the draw distance at its edge
+                    ChunkDetail detail = this->chunk_detail(
+                        chunk_x, chunk_z, draw_distance
+                    );
+                    this->prefetch_chunk(
+                        chunk_x, chunk_z, detail, started_builds
+                    );
+                    visited_chunks += 1;
+                }
+            }
+            prev_x = center_x;
+            prev_z = center_z;
         }
-        return {
-            chunk_x, chunk_z, false, 
-            this->build_chunk_terrain_geometry((u64) chunk_x, (u64) chunk_z),
-            this->build_chunk_water_geometry(chunk_x, chunk_z),
-            this->collect_foliage_transforms((u64) chunk_x, (u64) chunk_z),
-            this->collect_building_transforms((u64) chunk_x, (u64) chunk_z),
-            this->collect_resource_transforms((u64) chunk_x, (u64) chunk_z),
-            this->collect_track_piece_transforms((u64) chunk_x, (u64) chunk_z),
-            this->create_chunk_interactables(
-                (u64) chunk_x, (u64) chunk_z, interactables, window, world
-            ),
-            this->create_chunk_particle_spawners((u64) chunk_x, (u64) chunk_z)
-        };
     }
 
+    // maximum number of built chunks to upload to the GPU each frame
+    static const u64 max_chunk_uploads = 4;
+
     bool Terrain::chunk_in_draw_distance(
         u64 chunk_x, u64 chunk_z, u64 draw_distance
     ) const {
@@ -535,15 +1081,24 @@ namespace houseofatmos::world {
         return mh_dist <= (i64) draw_distance;
     }
 
-    bool Terrain::chunk_loaded(u64 chunk_x, u64 chunk_z, size_t& index) const {
-        for(size_t chunk_i = 0; chunk_i < this->loaded_chunks.size(); chunk_i += 1) {
-            const LoadedChunk& chunk = this->loaded_chunks.at(chunk_i);
-            if(chunk.x == (i64) chunk_x && chunk.z == (i64) chunk_z) {
-                index = chunk_i;
-                return true;
+    void Terrain::resize_chunk_slots(u64 size, u64 draw_distance) {
+        std::vector<std::optional<LoadedChunk>> old_slots 
+            = std::move(this->chunk_slots);
+        this->chunk_slots_size = size;
+        this->chunk_slots.clear();
+        this->chunk_slots.resize(size * size);
+        this->chunk_builds.clear();
+        this->chunk_builds.resize(size * size);
+        this->reset_slot_instances();
+        for(std::optional<LoadedChunk>& chunk: old_slots) {
+            if(!chunk.has_value()) { continue; }
+            if(!this->chunk_in_draw_distance(chunk->x, chunk->z, draw_distance)) {
+                continue;
             }
+            size_t slot_i = this->chunk_slot_index(chunk->x, chunk->z);
+            this->chunk_slots[slot_i] = std::move(chunk);
+            this->update_slot_instances(slot_i, AllChunkParts);
         }
-        return false;
     }
 
     void Terrain::load_chunks_around(
@@ -552,76 +1107,174 @@ namespace houseofatmos::world {
     ) {
         this->view_chunk_x = (u64) (position.x() / this->tile_size / this->chunk_tiles);
         this->view_chunk_z = (u64) (position.z() / this->tile_size / this->chunk_tiles);
-        // despawn chunks that are too far away
-        for(size_t chunk_i = 0; chunk_i < this->loaded_chunks.size();) {
-            const LoadedChunk& chunk = this->loaded_chunks.at(chunk_i);
-            if(this->chunk_in_draw_distance(chunk.x, chunk.z, draw_distance)) {
-                chunk_i += 1;
-                continue;
-            }
-            this->loaded_chunks.erase(this->loaded_chunks.begin() + chunk_i);
-        }
-        // spawn and update chunks in the draw distance
-        i64 viewed_start_x = this->view_chunk_x - (i64) draw_distance;
-        i64 viewed_end_x = this->view_chunk_x + (i64) draw_distance;
-        i64 viewed_start_z = this->view_chunk_z - (i64) draw_distance;
-        i64 viewed_end_z = this->view_chunk_z + (i64) draw_distance;
-        for(i64 chunk_x = viewed_start_x; chunk_x <= viewed_end_x; chunk_x += 1) {
-            for(i64 chunk_z = viewed_start_z; chunk_z <= viewed_end_z; chunk_z += 1) {
-                bool in_bounds = chunk_x >= 0 && chunk_z >= 0
-                    && chunk_x < (i64) this->width_chunks
-                    && chunk_z < (i64) this->height_chunks;
-                size_t chunk_i;
-                if(!this->chunk_loaded(chunk_x, chunk_z, chunk_i)) {
-                    this->loaded_chunks.push_back(
-                        this->load_chunk(
-                            chunk_x, chunk_z, interactables, window, world,
-                            in_bounds
-                        )
+        u64 slots_size = draw_distance * 2 + 1;
+        if(slots_size != this->chunk_slots_size) {
+            this->resize_chunk_slots(slots_size, draw_distance);
+        }
+        // Spawn and update chunks in the draw distance, starting with the
+        // chunks closest to the viewer. Since every slot is visited, chunks 
+        // that are too far away get replaced here once their replacement
+        // has been built.
+        u64 uploaded_chunks = 0;
+        for(i64 dist = 0; dist <= (i64) draw_distance; dist += 1) {
+            for(i64 off_x = -dist; off_x <= dist; off_x += 1) {
+                for(i64 off_z = -dist; off_z <= dist; off_z += 1) {
+                    if(std::max(llabs(off_x), llabs(off_z)) != dist) { continue; }
+                    i64 chunk_x = this->view_chunk_x + off_x;
+                    i64 chunk_z = this->view_chunk_z + off_z;
+                    size_t slot_i = this->chunk_slot_index(chunk_x, chunk_z);
+                    std::optional<LoadedChunk>& slot = this->chunk_slots[slot_i];
+                    const std::shared_ptr<ChunkBuild>& build 
+                        = this->chunk_builds[slot_i];
+                    ChunkDetail detail = this->chunk_detail(
+                        chunk_x, chunk_z, (u64) dist
                     );
-                    continue; 
-                }
-                LoadedChunk& chunk = this->loaded_chunks.at(chunk_i);
-                if(chunk.modified) {
-                    chunk = this->load_chunk(
-                        chunk_x, chunk_z, interactables, window, world,
-                        in_bounds
+                    bool loaded = slot.has_value()
+                        && slot->x == chunk_x && slot->z == chunk_z;
+                    // the chunk in the slot left the draw distance, so stop
+                    // showing it until its replacement is done
+                    if(slot.has_value() && !loaded && !slot->hidden) {
+                        slot->hidden = true;
+                        slot->interactables.clear();
+                        slot->particle_spawners.clear();
+                        this->remove_slot_instances(slot_i);
+                    }
+                    // the chunk came back before it was replaced
+                    if(loaded && slot->hidden) {
+                        slot->hidden = false;
+                        slot->modified |= ChunkInteractables | ChunkSpawners;
+                        this->update_slot_instances(slot_i, AllChunkParts);
+                    }
+                    bool building = build != nullptr && !build->outdated
+                        && build->snapshot.x == chunk_x 
+                        && build->snapshot.z == chunk_z;
+                    // chunks that moved closer or further away need to be
+                    // rebuilt with a different level of detail
+                    u16 detail_parts = ChunkGround | ChunkWater;
+                    bool detail_pending = building
+                        && (build->parts & detail_parts) == detail_parts
+                        && build->snapshot.detail == detail;
+                    if(loaded && slot->detail != detail && !detail_pending) {
+                        slot->modified |= detail_parts;
+                    }
+                    if(loaded && slot->modified != 0) {
+                        u16 parts = slot->modified;
+                        slot->modified = 0;
+                        this->start_chunk_build(
+                            slot_i, chunk_x, chunk_z, detail, parts
+                        );
+                        continue;
+                    }
+                    if(!loaded && !building) {
+                        std::shared_ptr<ChunkBuild> cached 
+                            = this->take_cached_chunk(chunk_x, chunk_z);
+                        if(cached == nullptr) {
+                            this->start_chunk_build(
+                                slot_i, chunk_x, chunk_z, detail
+                            );
+                            continue;
+                        }
+                        this->discard_chunk_build(slot_i, chunk_x, chunk_z);
+                        this->chunk_builds[slot_i] = std::move(cached);
+                        building = true;
+                    }
+                    if(!building) { continue; }
+                    if(uploaded_chunks >= max_chunk_uploads) { continue; }
+                    bool uploaded = this->finish_chunk_build(
+                        slot_i, interactables, window, world
                     );
+                    if(uploaded) { uploaded_chunks += 1; }
                 }
             }
         }
+        this->prefetch_chunks(position, draw_distance, window);
     }
 
+    // A building handle consists of the index of the building in its chunk 
+    // (plus one, so that 0 means no building) and how many chunks the chunk
+    // of the building is to the left of / above the chunk of the tile.
+    static const u32 building_offset_bits = 2;
+    static const u32 building_offset_mask = (1 << building_offset_bits) - 1;
+
+    u32 Terrain::building_tile_handle(
+        size_t building_i, u64 chunk_offset_x, u64 chunk_offset_z
+    ) {
+        if(chunk_offset_x > building_offset_mask
+            || chunk_offset_z > building_offset_mask) {
+            engine::error("Building spans too many chunks!");
+        }
+        return ((u32) (building_i + 1) << (building_offset_bits * 2))
+            | ((u32) chunk_offset_x << building_offset_bits)
+            | (u32) chunk_offset_z;
+    }
 
     const Building* Terrain::building_at(
         i64 tile_x, i64 tile_z, u64* chunk_x_out, u64* chunk_z_out
     ) const {
-        i64 r_chunk_x = tile_x / (i64) this->chunk_tiles;
-        i64 r_chunk_z = tile_z / (i64) this->chunk_tiles;
-        for(i64 chunk_x = r_chunk_x - 1; chunk_x <= r_chunk_x + 1; chunk_x += 1) {
-            if(chunk_x < 0 || (u64) chunk_x >= this->width_chunks) { continue; }
-            for(i64 chunk_z = r_chunk_z - 1; chunk_z <= r_chunk_z + 1; chunk_z += 1) {
-                if(chunk_z < 0 || (u64) chunk_z >= this->height_chunks) { continue; }
-                const ChunkData& chunk = this->chunk_at(chunk_x, chunk_z);
-                i64 chunk_offset_x = chunk_x * this->chunk_tiles;
-                i64 chunk_offset_z = chunk_z * this->chunk_tiles;
-                for(const Building& building: chunk.buildings) {
-                    const Building::TypeInfo& type 
-                        = Building::types().at((size_t) building.type);
-                    i64 start_x = chunk_offset_x + (i64) building.x;
-                    i64 end_x = start_x + (i64) type.width;
-                    i64 start_z = chunk_offset_z + (i64) building.z;
-                    i64 end_z = start_z + (i64) type.height;
-                    bool overlaps = start_x <= tile_x && tile_x < end_x
-                        && start_z <= tile_z && tile_z < end_z;
-                    if(!overlaps) { continue; }
-                    if(chunk_x_out != nullptr) { *chunk_x_out = (u64) chunk_x; }
-                    if(chunk_z_out != nullptr) { *chunk_z_out = (u64) chunk_z; }
-                    return &building;
+        if(tile_x < 0 || tile_z < 0) { return nullptr; }
+        if((u64) tile_x >= this->width) { return nullptr; }
+        if((u64) tile_z >= this->height) { return nullptr; }
+        u32 handle = this->building_tiles[tile_x + tile_z * this->width];
+        if(handle == 0) { return nullptr; }
+        u64 chunk_x = (u64) tile_x / this->chunk_tiles
+            - ((handle >> building_offset_bits) & building_offset_mask);
+        u64 chunk_z = (u64) tile_z / this->chunk_tiles
+            - (handle & building_offset_mask);
+        size_t building_i = (handle >> (building_offset_bits * 2)) - 1;
+        if(chunk_x_out != nullptr) { *chunk_x_out = chunk_x; }
+        if(chunk_z_out != nullptr) { *chunk_z_out = chunk_z; }
+        return &this->chunk_at(chunk_x, chunk_z).buildings[building_i];
+    }
+
+    void Terrain::reindex_chunk_buildings(u64 chunk_x, u64 chunk_z) {
+        static const u64 max_building_size = []() {
+            u64 size = 0;
+            for(const Building::TypeInfo& type: Building::types()) {
+                size = std::max(size, (u64) std::max(type.width, type.height));
+            }
+            return size;
+        }();
+        u64 start_x = chunk_x * this->chunk_tiles;
+        u64 start_z = chunk_z * this->chunk_tiles;
+        u64 end_x = std::min(
+            start_x + this->chunk_tiles + max_building_size, this->width
+        );
+        u64 end_z = std::min(
+            start_z + this->chunk_tiles + max_building_size, this->height
+        );
+        // remove all tiles of buildings previously in the chunk
+        for(u64 z = start_z; z < end_z; z += 1) {
+            for(u64 x = start_x; x < end_x; x += 1) {
+                u32& handle = this->building_tiles[x + z * this->width];
+                if(handle == 0) { continue; }
+                u64 b_chunk_x = x / this->chunk_tiles
+                    - ((handle >> building_offset_bits) & building_offset_mask);
+                u64 b_chunk_z = z / this->chunk_tiles
+                    - (handle & building_offset_mask);
+                if(b_chunk_x != chunk_x || b_chunk_z != chunk_z) { continue; }
+                handle = 0;
+            }
+        }
+        const ChunkData& chunk = this->chunk_at(chunk_x, chunk_z);
+        for(size_t b_i = 0; b_i < chunk.buildings.size(); b_i += 1) {
+            const Building& building = chunk.buildings[b_i];
+            const Building::TypeInfo& type 
+                = Building::types().at((size_t) building.type);
+            u64 b_start_x = start_x + building.x;
+            u64 b_start_z = start_z + building.z;
+            u64 b_end_x = std::min(b_start_x + type.width, this->width);
+            u64 b_end_z = std::min(b_start_z + type.height, this->height);
+            for(u64 z = b_start_z; z < b_end_z; z += 1) {
+                for(u64 x = b_start_x; x < b_end_x; x += 1) {
+                    this->building_tiles[x + z * this->width] 
+                        = Terrain::building_tile_handle(
+                            b_i, 
+                            x / this->chunk_tiles - chunk_x, 
+                            z / this->chunk_tiles - chunk_z
+                        );
                 }
             }
         }
-        return nullptr;
     }
 
     Building* Terrain::building_at(
@@ -632,15 +1285,67 @@ namespace houseofatmos::world {
         );
     }
 
+    void Terrain::reindex_bridges() {
+        this->chunk_bridges.resize(this->width_chunks * this->height_chunks);
+        for(std::vector<u32>& chunk: this->chunk_bridges) { chunk.clear(); }
+        for(size_t bridge_i = 0; bridge_i < this->bridges.size(); bridge_i += 1) {
+            const Bridge& bridge = this->bridges[bridge_i];
+            u64 max_ch_x = std::min(
+                bridge.end_x / this->chunk_tiles, this->width_chunks - 1
+            );
+            u64 max_ch_z = std::min(
+                bridge.end_z / this->chunk_tiles, this->height_chunks - 1
+            );
+            for(u64 ch_x = bridge.start_x / this->chunk_tiles; ch_x <= max_ch_x; ch_x += 1) {
+                for(u64 ch_z = bridge.start_z / this->chunk_tiles; ch_z <= max_ch_z; ch_z += 1) {
+                    this->chunk_bridges[ch_x + ch_z * this->width_chunks]
+                        .push_back((u32) bridge_i);
+                }
+            }
+        }
+    }
+
+    // Calls 'handler' once for each bridge overlapping the given chunks.
+    template<typename F>
+    void Terrain::for_each_bridge_in(
+        u64 min_ch_x, u64 min_ch_z, u64 max_ch_x, u64 max_ch_z, F&& handler
+    ) const {
+        max_ch_x = std::min(max_ch_x, this->width_chunks - 1);
+        max_ch_z = std::min(max_ch_z, this->height_chunks - 1);
+        for(u64 ch_x = min_ch_x; ch_x <= max_ch_x; ch_x += 1) {
+            for(u64 ch_z = min_ch_z; ch_z <= max_ch_z; ch_z += 1) {
+                const std::vector<u32>& chunk 
+                    = this->chunk_bridges[ch_x + ch_z * this->width_chunks];
+                for(u32 bridge_i: chunk) {
+                    const Bridge& bridge = this->bridges[bridge_i];
+                    // bridges spanning multiple chunks are only handled 
+                    // in the first of the given chunks they overlap with
+                    u64 first_ch_x = std::max(
+                        bridge.start_x / this->chunk_tiles, min_ch_x
+                    );
+                    u64 first_ch_z = std::max(
+                        bridge.start_z / this->chunk_tiles, min_ch_z
+                    );
+                    if(first_ch_x != ch_x || first_ch_z != ch_z) { continue; }
+                    handler(bridge);
+                }
+            }
+        }
+    }
+
     const Bridge* Terrain::bridge_at(
         i64 tile_x_s, i64 tile_z_s, f64 closest_to_height
     ) const {
         if(tile_x_s < 0 || tile_z_s < 0) { return nullptr; }
         u64 tile_x = (u64) tile_x_s;
         u64 tile_z = (u64) tile_z_s;
+        if(tile_x >= this->width || tile_z >= this->height) { return nullptr; }
         const Bridge* closest = nullptr;
         f64 clostest_height_diff = INFINITY;
-        for(const Bridge& bridge: this->bridges) {
+        u64 chunk_x = tile_x / this->chunk_tiles;
+        u64 chunk_z = tile_z / this->chunk_tiles;
+        for(u32 bridge_i: this->chunk_bridges[chunk_x + chunk_z * this->width_chunks]) {
+            const Bridge& bridge = this->bridges[bridge_i];
             if(tile_x < bridge.start_x || bridge.end_x < tile_x) { continue; }
             if(tile_z < bridge.start_z || bridge.end_z < tile_z) { continue; }
             f64 height_diff = fabs((f64) bridge.floor_y - closest_to_height);
@@ -703,41 +1408,47 @@ namespace houseofatmos::world {
             );
             if(min_elev + 0.5 <= water_height) { return false; }
         }
-        for(const Bridge& bridge: this->bridges) {
-            bridge.report_malformed();
-            // "move" the start and end tiles of the bridge 
-            // to the start and ends of the player collider
-            // this minimizes the number of tiles we need to check
-            u64 x = std::max(
-                (u64) (player_collider.start.x() / this->tile_size),
-                bridge.start_x
-            );
-            u64 z = std::max(
-                (u64) (player_collider.start.z() / this->tile_size),
-                bridge.start_z
-            );
-            u64 end_x = std::min(
-                (u64) (player_collider.end.x() / this->tile_size),
-                bridge.end_x
-            );
-            u64 end_z = std::min(
-                (u64) (player_collider.end.z() / this->tile_size),
-                bridge.end_z
-            );
-            if(end_x < x || end_z < z) { continue; }
-            for(;;) {
-                for(const RelCollider& collider: bridge.colliders()) {
-                    Vec<3> segment_pos = Vec<3>(x, 0, z) * this->tile_size
-                        + Vec<3>(2.5, (f64) bridge.floor_y, 2.5);
-                    bool collides = player_collider
-                        .collides_with(collider.at(segment_pos));
-                    if(collides) { return false; }
+        u64 coll_start_x = (u64) std::max(
+            player_collider.start.x() / this->tile_size, 0.0
+        );
+        u64 coll_start_z = (u64) std::max(
+            player_collider.start.z() / this->tile_size, 0.0
+        );
+        u64 coll_end_x = (u64) std::max(
+            player_collider.end.x() / this->tile_size, 0.0
+        );
+        u64 coll_end_z = (u64) std::max(
+            player_collider.end.z() / this->tile_size, 0.0
+        );
+        bool hit_bridge = false;
+        this->for_each_bridge_in(
+            coll_start_x / this->chunk_tiles, coll_start_z / this->chunk_tiles,
+            coll_end_x / this->chunk_tiles, coll_end_z / this->chunk_tiles,
+            [&](const Bridge& bridge) {
+                if(hit_bridge) { return; }
+                bridge.report_malformed();
+                // "move" the start and end tiles of the bridge 
+                // to the start and ends of the player collider
+                // this minimizes the number of tiles we need to check
+                u64 x = std::max(coll_start_x, bridge.start_x);
+                u64 z = std::max(coll_start_z, bridge.start_z);
+                u64 end_x = std::min(coll_end_x, bridge.end_x);
+                u64 end_z = std::min(coll_end_z, bridge.end_z);
+                if(end_x < x || end_z < z) { return; }
+                for(;;) {
+                    for(const RelCollider& collider: bridge.colliders()) {
+                        Vec<3> segment_pos = Vec<3>(x, 0, z) * this->tile_size
+                            + Vec<3>(2.5, (f64) bridge.floor_y, 2.5);
+                        hit_bridge |= player_collider
+                            .collides_with(collider.at(segment_pos));
+                    }
+                    if(x < end_x) { x += 1; }
+                    else if(z < end_z) { z += 1; }
+                    else { break; }
                 }
-                if(x < end_x) { x += 1; }
-                else if(z < end_z) { z += 1; }
-                else { break; }
             }
-        }
+        );
+        if(hit_bridge) { return false; }
         u64 start_x = (u64) std::max(this->view_chunk_x - collision_test_dist, (i64) 0);
         u64 end_x = std::min((u64) (this->view_chunk_x + collision_test_dist), this->width_chunks - 1);
         u64 start_z = (u64) std::max(this->view_chunk_z - collision_test_dist, (i64) 0);
@@ -795,7 +1506,7 @@ namespace houseofatmos::world {
             }
             chunk.foliage.erase(chunk.foliage.begin() + foliage_i);
         }
-        this->reload_chunk_at(chunk_x, chunk_z);
+        this->reload_chunk_at(chunk_x, chunk_z, ChunkFoliage | ChunkSpawners);
     }
 
     void Terrain::adjust_area_foliage(
@@ -824,7 +1535,7 @@ namespace houseofatmos::world {
                         fol_i += 1;
                     }
                 }
-                this->reload_chunk_at(ch_x, ch_z);
+                this->reload_chunk_at(ch_x, ch_z, ChunkFoliage | ChunkSpawners);
             }
         }
     }
@@ -1000,6 +1711,13 @@ namespace houseofatmos::world {
         chunk.buildings.push_back((Building) {
             type, (u8) rel_x, (u8) rel_z, complex
         });
+        this->reindex_chunk_buildings(chunk_x, chunk_z);
+        this->reload_area(
+            (i64) tile_x - 1, (i64) tile_z - 1, 
+            (i64) (tile_x + type_info.width), (i64) (tile_z + type_info.height),
+            ChunkGround | ChunkWater | ChunkBuildings | ChunkResources 
+                | ChunkInteractables | ChunkSpawners
+        );
     }
     
 
@@ -1046,7 +1764,9 @@ namespace houseofatmos::world {
     void Terrain::spawn_particles(
         const engine::Window& window, ParticleManager& particles
     ) {
-        for(LoadedChunk& chunk: this->loaded_chunks) {
+        for(std::optional<LoadedChunk>& slot: this->chunk_slots) {
+            if(!slot.has_value() || slot->hidden) { continue; }
+            LoadedChunk& chunk = *slot;
             for(ParticleSpawner& spawner: chunk.particle_spawners) {
                 spawner.spawn(window, particles);
             }
@@ -1054,51 +1774,133 @@ namespace houseofatmos::world {
     }
 
 
+    void Terrain::InstanceCollection::reset(
+        size_t type_count, size_t slot_count
+    ) {
+        this->types.resize(type_count);
+        // keep the allocations of each type for when they are filled again
+        for(std::vector<Mat<4>>& type_instances: this->types) {
+            type_instances.clear();
+        }
+        this->ranges.assign(slot_count * type_count, Range(0, 0));
+    }
+
+    void Terrain::InstanceCollection::remove_range(
+        size_t slot_i, size_t type_i
+    ) {
+        size_t type_count = this->types.size();
+        Range& removed = this->ranges[slot_i * type_count + type_i];
+        if(removed.count == 0) { return; }
+        std::vector<Mat<4>>& type_instances = this->types[type_i];
+        auto start = type_instances.begin() + removed.offset;
+        type_instances.erase(start, start + removed.count);
+        // ranges after the removed one move down to fill the gap
+        for(
+            size_t range_i = type_i; 
+            range_i < this->ranges.size(); 
+            range_i += type_count
+        ) {
+            Range& range = this->ranges[range_i];
+            if(range.offset > removed.offset) { range.offset -= removed.count; }
+        }
+        removed = Range(0, 0);
+    }
+
+    void Terrain::InstanceCollection::remove_slot(size_t slot_i) {
+        for(size_t type_i = 0; type_i < this->types.size(); type_i += 1) {
+            this->remove_range(slot_i, type_i);
+        }
+    }
+
+    template<typename T>
+    void Terrain::InstanceCollection::set_slot(
+        size_t slot_i, 
+        const std::unordered_map<T, std::vector<Mat<4>>>& instances
+    ) {
+        size_t type_count = this->types.size();
+        for(size_t type_i = 0; type_i < type_count; type_i += 1) {
+            auto new_instances = instances.find((T) type_i);
+            size_t new_count = new_instances == instances.end()
+                ? 0 : new_instances->second.size();
+            Range& range = this->ranges[slot_i * type_count + type_i];
+            std::vector<Mat<4>>& type_instances = this->types[type_i];
+            if(range.count != new_count) {
+                this->remove_range(slot_i, type_i);
+                range = Range(type_instances.size(), new_count);
+                type_instances.resize(type_instances.size() + new_count);
+            }
+            if(new_count == 0) { continue; }
+            std::copy(
+                new_instances->second.begin(), new_instances->second.end(),
+                type_instances.begin() + range.offset
+            );
+        }
+    }
+
+    void Terrain::reset_slot_instances() {
+        size_t slot_count = this->chunk_slots.size();
+        this->foliage_instances.reset(Foliage::types().size(), slot_count);
+        this->building_instances.reset(Building::types().size(), slot_count);
+        this->resource_instances.reset(Resource::types().size(), slot_count);
+        this->track_piece_instances
+            .reset(TrackPiece::types().size(), slot_count);
+    }
+
+    void Terrain::update_slot_instances(size_t slot_i, u16 parts) {
+        const LoadedChunk& chunk = *this->chunk_slots[slot_i];
+        if(parts & ChunkFoliage) {
+            this->foliage_instances.set_slot(slot_i, chunk.foliage);
+        }
+        if(parts & ChunkBuildings) {
+            this->building_instances.set_slot(slot_i, chunk.buildings);
+        }
+        if(parts & ChunkResources) {
+            this->resource_instances.set_slot(slot_i, chunk.resources);
+        }
+        if(parts & ChunkTrack) {
+            this->track_piece_instances.set_slot(slot_i, chunk.track_pieces);
+        }
+    }
+
+    void Terrain::remove_slot_instances(size_t slot_i) {
+        this->foliage_instances.remove_slot(slot_i);
+        this->building_instances.remove_slot(slot_i);
+        this->resource_instances.remove_slot(slot_i);
+        this->track_piece_instances.remove_slot(slot_i);
+    }
+
     void Terrain::render_loaded_chunks(
         engine::Scene& scene, Renderer& renderer,
         const engine::Window& window
     ) {
-        std::unordered_map<Foliage::Type, std::vector<Mat<4>>> foliage_instances;
-        std::unordered_map<Building::Type, std::vector<Mat<4>>> building_instances;
-        std::unordered_map<Resource::Type, std::vector<Mat<4>>> resource_instances;
-        std::unordered_map<TrackPiece::Type, std::vector<Mat<4>>> track_piece_instances;
-        for(LoadedChunk& chunk: this->loaded_chunks) {
+        for(std::optional<LoadedChunk>& slot: this->chunk_slots) {
+            if(!slot.has_value() || slot->hidden) { continue; }
+            LoadedChunk& chunk = *slot;
             Vec<3> chunk_offset = Vec<3>(chunk.x, 0, chunk.z)
                 * this->chunk_tiles * this->tile_size;
             this->render_chunk_ground(
                 chunk, scene.get(Terrain::ground_texture), chunk_offset, renderer
             );
-            for(const auto& [foliage_type, instances]: chunk.foliage) {
-                std::vector<Mat<4>>& f_inst = foliage_instances[foliage_type];
-                f_inst.insert(f_inst.end(), instances.begin(), instances.end());
-            }
-            for(const auto& [building_type, instances]: chunk.buildings) {
-                std::vector<Mat<4>>& b_inst = building_instances[building_type];
-                b_inst.insert(b_inst.end(), instances.begin(), instances.end());
-            }
-            for(const auto& [resource_type, instances]: chunk.resources) {
-                std::vector<Mat<4>>& r_inst = resource_instances[resource_type];
-                r_inst.insert(r_inst.end(), instances.begin(), instances.end());
-            }
-            for(const auto& [track_piece_type, instances]: chunk.track_pieces) {
-                std::vector<Mat<4>>& p_inst = track_piece_instances[track_piece_type];
-                p_inst.insert(p_inst.end(), instances.begin(), instances.end());
-            }
         }
-        for(const auto& [foliage_type, instances]: foliage_instances) {
-            engine::Model& model = scene.get(
-                Foliage::types().at((size_t) foliage_type).model
-            );
+        for(size_t type_i = 0; type_i < this->foliage_instances.types.size(); type_i += 1) {
+            const std::vector<Mat<4>>& instances 
+                = this->foliage_instances.types[type_i];
+            if(instances.size() == 0) { continue; }
+            engine::Model& model = scene.get(Foliage::types().at(type_i).model);
             renderer.render(model, instances);
         }
-        for(const auto& [building_type, instances]: building_instances) {
-            const Building::TypeInfo& type_info
-                = Building::types().at((size_t) building_type);
+        for(size_t type_i = 0; type_i < this->building_instances.types.size(); type_i += 1) {
+            const std::vector<Mat<4>>& instances 
+                = this->building_instances.types[type_i];
+            if(instances.size() == 0) { continue; }
+            const Building::TypeInfo& type_info = Building::types().at(type_i);
             type_info.render_buildings(window, scene, renderer, instances);
         }
-        for(const auto& [resource_type, instances]: resource_instances) {
-            const Resource::TypeInfo& type_info
-                = Resource::types().at((size_t) resource_type);
+        for(size_t type_i = 0; type_i < this->resource_instances.types.size(); type_i += 1) {
+            const std::vector<Mat<4>>& instances 
+                = this->resource_instances.types[type_i];
+            if(instances.size() == 0) { continue; }
+            const Resource::TypeInfo& type_info = Resource::types().at(type_i);
             renderer.render(
                 scene.get(type_info.model), instances, nullptr, 0.0,
                 engine::FaceCulling::Enabled,
@@ -1106,9 +1908,12 @@ namespace houseofatmos::world {
                 &scene.get(type_info.texture)
             );
         }
-        for(const auto& [track_piece_type, instances]: track_piece_instances) {
-            const TrackPiece::TypeInfo& piece_type_info = TrackPiece::types()
-                .at((size_t) track_piece_type);
+        for(size_t type_i = 0; type_i < this->track_piece_instances.types.size(); type_i += 1) {
+            const std::vector<Mat<4>>& instances 
+                = this->track_piece_instances.types[type_i];
+            if(instances.size() == 0) { continue; }
+            const TrackPiece::TypeInfo& piece_type_info 
+                = TrackPiece::types().at(type_i);
             renderer.render(
                 scene.get(piece_type_info.model), instances, nullptr, 0.0
             );
@@ -1122,10 +1927,15 @@ namespace houseofatmos::world {
         const Vec<3>& chunk_offset,
         Renderer& renderer
     ) {
-        renderer.render(
+        f64 chunk_size = (f64) (this->chunk_tiles * this->tile_size);
+        f64 min_y = (f64) loaded_chunk.min_elevation;
+        f64 max_y = (f64) loaded_chunk.max_elevation;
+        Vec<3> bounds_size = Vec<3>(chunk_size, max_y - min_y, chunk_size);
+        renderer.render_terrain(
             loaded_chunk.terrain, ground_texture, 
-            Mat<4>(),
-            std::array { Mat<4>::translate(chunk_offset) }
+            Mat<4>::translate(chunk_offset),
+            Vec<3>(chunk_size / 2.0, (min_y + max_y) / 2.0, chunk_size / 2.0),
+            bounds_size.len() / 2.0
         );
     }
 
@@ -1142,20 +1952,27 @@ namespace houseofatmos::world {
             * (i64) this->tiles_per_chunk();
         std::vector<std::vector<Mat<4>>> instances;
         instances.resize(Bridge::types().size());
-        for(const Bridge& bridge: this->bridges) {
-            bool not_visible = (i64) bridge.end_x < view_start_x
-                || (i64) bridge.start_x > view_end_x
-                || (i64) bridge.end_z < view_start_z
-                || (i64) bridge.start_z > view_end_z;
-            if(not_visible) { continue; }
-            size_t type_id = (size_t) bridge.type;
-            std::vector<Mat<4>> bridge_instances = bridge
-                .get_instances(this->units_per_tile());
-            instances[type_id].insert(
-                instances[type_id].end(), 
-                bridge_instances.begin(), bridge_instances.end()
-            );
-        }
+        i64 tpc = (i64) this->tiles_per_chunk();
+        this->for_each_bridge_in(
+            (u64) std::max(view_start_x / tpc, (i64) 0), 
+            (u64) std::max(view_start_z / tpc, (i64) 0),
+            (u64) std::max(view_end_x / tpc, (i64) 0), 
+            (u64) std::max(view_end_z / tpc, (i64) 0),
+            [&](const Bridge& bridge) {
+                bool not_visible = (i64) bridge.end_x < view_start_x
+                    || (i64) bridge.start_x > view_end_x
+                    || (i64) bridge.end_z < view_start_z
+                    || (i64) bridge.start_z > view_end_z;
+                if(not_visible) { return; }
+                size_t type_id = (size_t) bridge.type;
+                std::vector<Mat<4>> bridge_instances = bridge
+                    .get_instances(this->units_per_tile());
+                instances[type_id].insert(
+                    instances[type_id].end(), 
+                    bridge_instances.begin(), bridge_instances.end()
+                );
+            }
+        );
         for(size_t type_id = 0; type_id < instances.size(); type_id += 1) {
             if(instances[type_id].size() == 0) { continue; }
             const Bridge::TypeInfo& type = Bridge::types().at(type_id);
@@ -1185,7 +2002,9 @@ namespace houseofatmos::world {
         shader.set_uniform("u_time", window.time());
         renderer.set_fog_uniforms(shader);
         renderer.set_shadow_uniforms(shader);
-        for(LoadedChunk& chunk: this->loaded_chunks) {
+        for(std::optional<LoadedChunk>& slot: this->chunk_slots) {
+            if(!slot.has_value() || slot->hidden) { continue; }
+            LoadedChunk& chunk = *slot;
             Vec<3> chunk_offset = Vec<3>(chunk.x, 0, chunk.z)
                 * this->chunk_tiles * this->tile_size;
             shader.set_uniform("u_local_transf", Mat<4>());
@@ -1215,6 +2034,13 @@ namespace houseofatmos::world {
             }
         );
         buffer.copy_into(serialized.bridges, this->bridges);
+        this->reindex_bridges();
+        this->building_tiles.resize(this->width * this->height);
+        for(u64 chunk_x = 0; chunk_x < this->width_chunks; chunk_x += 1) {
+            for(u64 chunk_z = 0; chunk_z < this->height_chunks; chunk_z += 1) {
+                this->reindex_chunk_buildings(chunk_x, chunk_z);
+            }
+        }
     }
 
     Terrain::ChunkData::ChunkData(
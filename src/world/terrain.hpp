@@ -10,6 +10,8 @@
 #include "bridge.hpp"
 #include "resource.hpp"
 #include "train_track.hpp"
+#include <atomic>
+#include <list>
 
 namespace houseofatmos::world {
 
@@ -39,10 +41,35 @@ namespace houseofatmos::world {
         };
 
 
+        // parts of a loaded chunk that can be rebuilt individually
+        enum ChunkPart : u16 {
+            ChunkGround = 1 << 0,
+            ChunkWater = 1 << 1,
+            ChunkFoliage = 1 << 2,
+            ChunkBuildings = 1 << 3,
+            ChunkResources = 1 << 4,
+            ChunkTrack = 1 << 5,
+            ChunkInteractables = 1 << 6,
+            ChunkSpawners = 1 << 7,
+            AllChunkParts = (1 << 8) - 1
+        };
+
+        // level of detail used to build the terrain and water of a chunk
+        struct ChunkDetail {
+            u64 tile_step; // width and height of each terrain quad in tiles
+            bool skirts; // hide gaps to chunks with a different tile step
+
+            bool operator==(const ChunkDetail& other) const = default;
+        };
+
         struct LoadedChunk {
             i64 x, z; // in chunks relative to origin
-            bool modified; // re-mesh in next render cycle
+            u16 modified; // parts to rebuild in next render cycle
+            // left the draw distance, but its slot has not been replaced yet
+            bool hidden;
+            ChunkDetail detail; // of the terrain and water geometry
             engine::Mesh terrain; // terrain geometry
+            i16 min_elevation, max_elevation; // of the terrain geometry
             engine::Mesh water; // water geometry
             std::unordered_map<Foliage::Type, std::vector<Mat<4>>> foliage;
             std::unordered_map<Building::Type, std::vector<Mat<4>>> buildings;
@@ -88,6 +115,41 @@ namespace houseofatmos::world {
             Serialized serialize(engine::Arena& buffer) const;
         };
 
+        // Copy of all terrain data needed to build a loaded chunk, allowing
+        // chunks to be built on worker threads while the terrain changes.
+        struct ChunkSnapshot {
+            i64 x, z; // in chunks relative to origin
+            u64 width, height; // in-bounds tiles of the chunk (0 if none)
+            u64 tile_size;
+            u64 chunk_tiles;
+            ChunkDetail detail;
+            u8 skirt_edges; // edges of the chunk that get skirts
+            // row-major 2D vector of each tile corner height in the chunk
+            // .size() = (width + 1) * (height + 1)
+            std::vector<i16> elevation;
+            // row-major 2D vector of the building flags of each tile
+            // .size() = width * height
+            std::vector<u8> building_tiles;
+            std::optional<ChunkData> data; // empty if out of bounds
+
+            i16 elevation_at(u64 rel_x, u64 rel_z) const {
+                return this->elevation[rel_x + (this->width + 1) * rel_z];
+            }
+        };
+
+        struct ChunkBuild {
+            ChunkSnapshot snapshot;
+            u16 parts; // parts of 'chunk' that get built
+            LoadedChunk chunk;
+            bool outdated = false; // terrain was modified since the snapshot
+            // only read 'chunk' once this is set
+            std::atomic<bool> completed = false;
+
+            ChunkBuild(ChunkSnapshot&& snapshot, u16 parts);
+            // for chunks that have already been built
+            ChunkBuild(LoadedChunk&& chunk);
+        };
+
         struct Serialized {
             u64 width, height;
             engine::Arena::Array<i16> elevation;
@@ -101,22 +163,79 @@ namespace houseofatmos::world {
         u64 chunk_tiles;
         u64 width_chunks, height_chunks;
         i64 view_chunk_x, view_chunk_z;
-        std::vector<LoadedChunk> loaded_chunks;
+        // Loaded chunks are kept in a square grid of slots that wraps around
+        // at its edges, meaning each chunk in the draw distance has a fixed 
+        // slot that it shares with no other chunk in the draw distance.
+        std::vector<std::optional<LoadedChunk>> chunk_slots;
+        u64 chunk_slots_size = 0; // width and height of the slot grid
+        // Chunks are built on worker threads and only replace the contents
+        // of their slot once done, which is shown in the meantime.
+        // .size() = chunk_slots.size()
+        std::vector<std::shared_ptr<ChunkBuild>> chunk_builds;
+        // Built chunks outside of the draw distance, most recently used first.
+        // Holds chunks built ahead of time in the direction of travel and
+        // chunks that recently left the draw distance.
+        std::list<std::shared_ptr<ChunkBuild>> chunk_cache;
+        std::optional<Vec<3>> last_view_position;
+        // Instances of all loaded chunks in one array per type, so that each
+        // type can be drawn at once. Each chunk slot owns a range of every
+        // array, which is the only part rewritten when the slot changes.
+        struct InstanceCollection {
+            struct Range {
+                size_t offset, count;
+            };
+
+            std::vector<std::vector<Mat<4>>> types;
+            // .size() = chunk_slots.size() * types.size()
+            std::vector<Range> ranges;
+
+            void reset(size_t type_count, size_t slot_count);
+            void remove_range(size_t slot_i, size_t type_i);
+            void remove_slot(size_t slot_i);
+            template<typename T>
+            void set_slot(
+                size_t slot_i, 
+                const std::unordered_map<T, std::vector<Mat<4>>>& instances
+            );
+        };
+        InstanceCollection foliage_instances;
+        InstanceCollection building_instances;
+        InstanceCollection resource_instances;
+        InstanceCollection track_piece_instances;
         // row-major 2D vector of each tile corner height
         // .size() = (width + 1) * (height + 1)
         std::vector<i16> elevation;
         // row-major 2D vector of chunks
         // .size() = width_chunks * height_chunks
         std::vector<ChunkData> chunks; 
+        // row-major 2D vector of the building on each tile (0 if none)
+        // .size() = width * height
+        std::vector<u32> building_tiles;
+        // row-major 2D vector of the indices of all bridges in each chunk
+        // .size() = width_chunks * height_chunks
+        std::vector<std::vector<u32>> chunk_bridges;
+
+        static u32 building_tile_handle(
+            size_t building_i, u64 chunk_offset_x, u64 chunk_offset_z
+        );
 
-        std::unordered_map<Foliage::Type, std::vector<Mat<4>>>
-            collect_foliage_transforms(u64 chunk_x, u64 chunk_z) const;
-        std::unordered_map<Building::Type, std::vector<Mat<4>>>
-            collect_building_transforms(u64 chunk_x, u64 chunk_z) const;
-        std::unordered_map<Resource::Type, std::vector<Mat<4>>>
-            collect_resource_transforms(u64 chunk_x, u64 chunk_z) const;
-        std::unordered_map<TrackPiece::Type, std::vector<Mat<4>>>
-            collect_track_piece_transforms(u64 chunk_x, u64 chunk_z) const;
+        f64 chunk_detail_error(i64 chunk_x, i64 chunk_z, u64 tile_step) const;
+        ChunkDetail chunk_detail(i64 chunk_x, i64 chunk_z, u64 distance) const;
+        ChunkSnapshot snapshot_chunk(
+            i64 chunk_x, i64 chunk_z, ChunkDetail detail
+        ) const;
+        static void build_chunk_terrain_geometry(
+            const ChunkSnapshot& snapshot, engine::Mesh& geometry
+        );
+        static void build_chunk_water_geometry(
+            const ChunkSnapshot& snapshot, engine::Mesh& geometry
+        );
+        static Mat<4> building_transform(
+            const Building& building, const ChunkSnapshot& snapshot
+        );
+        static void build_chunk(
+            const ChunkSnapshot& snapshot, u16 parts, LoadedChunk& loaded
+        );
         std::vector<std::shared_ptr<Interactable>> create_chunk_interactables(
             u64 chunk_x, u64 chunk_z, 
             Interactables* interactables, engine::Window& window, 
@@ -125,12 +244,41 @@ namespace houseofatmos::world {
         std::vector<ParticleSpawner> create_chunk_particle_spawners(
             u64 chunk_x, u64 chunk_z
         );
-        Terrain::LoadedChunk load_chunk(
-            i64 chunk_x, i64 chunk_z, 
+        template<typename F>
+        void for_each_bridge_in(
+            u64 min_ch_x, u64 min_ch_z, u64 max_ch_x, u64 max_ch_z, F&& handler
+        ) const;
+        bool chunk_in_bounds(i64 chunk_x, i64 chunk_z) const {
+            return chunk_x >= 0 && chunk_z >= 0
+                && chunk_x < (i64) this->width_chunks
+                && chunk_z < (i64) this->height_chunks;
+        }
+        u16 discard_chunk_build(size_t slot_i, i64 chunk_x, i64 chunk_z);
+        void start_chunk_build(
+            size_t slot_i, i64 chunk_x, i64 chunk_z, ChunkDetail detail,
+            u16 parts = AllChunkParts
+        );
+        std::shared_ptr<ChunkBuild> take_cached_chunk(i64 chunk_x, i64 chunk_z);
+        void cache_chunk(std::shared_ptr<ChunkBuild>&& build);
+        void prefetch_chunk(
+            i64 chunk_x, i64 chunk_z, ChunkDetail detail, u64& started_builds
+        );
+        void prefetch_chunks(
+            const Vec<3>& position, u64 draw_distance,
+            const engine::Window& window
+        );
+        bool finish_chunk_build(
+            size_t slot_i, 
             Interactables* interactables, engine::Window& window, 
-            const std::shared_ptr<World>& world,
-            bool in_bounds = true
+            const std::shared_ptr<World>& world
         );
+        size_t chunk_slot_index(i64 chunk_x, i64 chunk_z) const {
+            i64 size = (i64) this->chunk_slots_size;
+            i64 slot_x = ((chunk_x % size) + size) % size;
+            i64 slot_z = ((chunk_z % size) + size) % size;
+            return (size_t) (slot_x + slot_z * size);
+        }
+        void resize_chunk_slots(u64 size, u64 draw_distance);
 
 
         public:
@@ -164,6 +312,8 @@ namespace houseofatmos::world {
             this->chunks = std::vector<ChunkData>(
                 width_chunks * height_chunks, ChunkData(chunk_tiles)
             );
+            this->building_tiles.resize(width * height);
+            this->chunk_bridges.resize(width_chunks * height_chunks);
         }
         
         Terrain(
@@ -193,18 +343,29 @@ namespace houseofatmos::world {
         const ChunkData& chunk_at(u64 chunk_x, u64 chunk_z) const {
             return this->chunks.at(chunk_x + this->width_chunks * chunk_z);
         }
-        void reload_chunk_at(u64 chunk_x, u64 chunk_z) {
-            auto chunk = this->loaded_chunk_at((i64) chunk_x, (i64) chunk_z);
-            if(chunk != nullptr) { chunk->modified = true; }
-        }
+        void reload_chunk_at(
+            u64 chunk_x, u64 chunk_z, u16 parts = AllChunkParts
+        );
+        // reloads the given parts of all chunks overlapping the tile area
+        void reload_area(
+            i64 min_x, i64 min_z, i64 max_x, i64 max_z, 
+            u16 parts = AllChunkParts
+        );
         LoadedChunk* loaded_chunk_at(i64 chunk_x, i64 chunk_z) {
-            for(LoadedChunk& chunk: this->loaded_chunks) {
-                if(chunk.x != chunk_x || chunk.z != chunk_z) { continue; }
-                return &chunk;
+            if(this->chunk_slots_size == 0) { return nullptr; }
+            std::optional<LoadedChunk>& slot 
+                = this->chunk_slots[this->chunk_slot_index(chunk_x, chunk_z)];
+            if(!slot.has_value()) { return nullptr; }
+            if(slot->x != chunk_x || slot->z != chunk_z) { return nullptr; }
+            return &*slot;
+        }
+        std::vector<LoadedChunk*> all_loaded_chunks() {
+            std::vector<LoadedChunk*> loaded;
+            for(std::optional<LoadedChunk>& slot: this->chunk_slots) {
+                if(slot.has_value()) { loaded.push_back(&*slot); }
             }
-            return nullptr;
+            return loaded;
         }
-        std::span<LoadedChunk> all_loaded_chunks() { return this->loaded_chunks; }
         Building* building_at(
             i64 tile_x, i64 tile_z, 
             u64* chunk_x_out = nullptr, u64* chunk_z_out = nullptr
@@ -213,6 +374,8 @@ namespace houseofatmos::world {
             i64 tile_x, i64 tile_z, 
             u64* chunk_x_out = nullptr, u64* chunk_z_out = nullptr
         ) const;
+        // must be called after the buildings of a chunk have been modified
+        void reindex_chunk_buildings(u64 chunk_x, u64 chunk_z);
         bool path_at(i64 tile_x, i64 tile_z) const {
             if(tile_x < 0 || tile_z < 0) { return false; }
             if((u64) tile_x >= this->width) { return false; }
@@ -239,6 +402,8 @@ namespace houseofatmos::world {
         const Bridge* bridge_at(
             i64 tile_x, i64 tile_z, f64 closest_to_height = 0.0
         ) const;
+        // must be called after bridges have been added or removed
+        void reindex_bridges();
         const Resource* resource_at(i64 tile_x, i64 tile_z) const;
         u64 track_pieces_at(
             i64 tile_x, i64 tile_z, 
@@ -282,7 +447,6 @@ namespace houseofatmos::world {
         bool chunk_in_draw_distance(
             u64 chunk_x, u64 chunk_z, u64 draw_distance
         ) const;
-        bool chunk_loaded(u64 chunk_x, u64 chunk_z, size_t& index) const;
         void load_chunks_around(
             const Vec<3>& position, u64 draw_distance,
             Interactables* interactables, engine::Window& window, 
@@ -308,6 +472,9 @@ namespace houseofatmos::world {
             const engine::Window& window
         );
         private:
+        void reset_slot_instances();
+        void update_slot_instances(size_t slot_i, u16 parts);
+        void remove_slot_instances(size_t slot_i);
         void render_chunk_ground(
             LoadedChunk& loaded_chunk,
             const engine::Texture& ground_texture, 
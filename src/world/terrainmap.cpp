@@ -956,6 +956,7 @@ namespace houseofatmos::world {
         switch(agent_d.state_of(agent)) {
             case AgentState::Idle:
                 status = "ui_status_no_instructions"; break;
+            case AgentState::Routing:
             case AgentState::Travelling: 
                 status = "ui_status_travelling"; break;
             case AgentState::Loading: 
@@ -0,0 +1,606 @@
+
+#include "tile_network.hpp"
+
+namespace houseofatmos::world {
+
+    void ChunkEntranceGraph::collect_next_nodes(
+        std::optional<NodeId> prev, NodeId node, 
+        std::vector<std::pair<NodeId, u64>>& out
+    ) {
+        (void) prev;
+        if(node == this->start) {
+            out.insert(
+                out.end(), this->start_edges.begin(), this->start_edges.end()
+            );
+        }
+        const Chunk& chunk = this->chunks[this->chunk_index_of(node)];
+        size_t entrance_c = chunk.entrances.size();
+        for(size_t from_i = 0; from_i < entrance_c; from_i += 1) {
+            const Entrance& from = chunk.entrances[from_i];
+            if(from.tile != node) { continue; }
+            out.push_back({ from.partner, TileNetwork::cost_ortho });
+            for(size_t to_i = 0; to_i < entrance_c; to_i += 1) {
+                const Entrance& to = chunk.entrances[to_i];
+                u64 cost = chunk.costs[from_i * entrance_c + to_i];
+                if(to.tile == node || cost == UINT64_MAX) { continue; }
+                out.push_back({ to.tile, cost });
+            }
+        }
+    }
+
+    u64 ChunkEntranceGraph::node_target_dist(NodeId node, ComplexId target) {
+        (void) target;
+        auto [nx, nz] = node;
+        u64 tpc = this->terrain->tiles_per_chunk();
+        u64 width_chunks = this->terrain->width_in_chunks();
+        u64 closest = UINT64_MAX;
+        for(u64 chunk_i: this->goal_chunks) {
+            u64 csx = (chunk_i % width_chunks) * tpc;
+            u64 csz = (chunk_i / width_chunks) * tpc;
+            u64 cex = csx + tpc - 1;
+            u64 cez = csz + tpc - 1;
+            u64 dx = nx < csx? csx - nx : nx > cex? nx - cex : 0;
+            u64 dz = nz < csz? csz - nz : nz > cez? nz - cez : 0;
+            closest = std::min(closest, dx + dz);
+        }
+        return closest;
+    }
+
+    bool ChunkEntranceGraph::node_at_target(NodeId node, ComplexId target) {
+        (void) target;
+        u64 chunk_i = this->chunk_index_of(node);
+        return std::find(this->goal_chunks.begin(), this->goal_chunks.end(), 
+            chunk_i) != this->goal_chunks.end();
+    }
+
+
+
+    // Calls 'handler' with the bounds of the area around each member of 
+    // the target that tiles at the target may be inside of.
+    template<typename F>
+    static void for_each_target_area(
+        const TileNetwork& network, ComplexId target, F&& handler
+    ) {
+        const Terrain& terrain = *network.terrain;
+        const Complex& complex = network.complexes->get(target);
+        for(const auto& [member_pos, member]: complex.get_members()) {
+            (void) member;
+            auto [bx, bz] = member_pos;
+            const Building* building = terrain.building_at((i64) bx, (i64) bz);
+            if(building == nullptr) { continue; }
+            const Building::TypeInfo& building_type = Building::types()
+                .at((size_t) building->type);
+            u64 reach = network.max_target_dist;
+            u64 min_x = bx > reach? bx - reach : 0;
+            u64 min_z = bz > reach? bz - reach : 0;
+            u64 max_x = std::min(
+                bx + building_type.width - 1 + reach, 
+                terrain.width_in_tiles() - 1
+            );
+            u64 max_z = std::min(
+                bz + building_type.height - 1 + reach, 
+                terrain.height_in_tiles() - 1
+            );
+            handler(min_x, min_z, max_x, max_z);
+        }
+    }
+
+    void TileNetwork::chunk_distances(
+        u64 chunk_x, u64 chunk_z, NodeId from, std::vector<u64>& out
+    ) {
+        u64 tpc = this->terrain->tiles_per_chunk();
+        u64 origin_x = chunk_x * tpc;
+        u64 origin_z = chunk_z * tpc;
+        auto index_of = [&](NodeId tile) {
+            return (size_t) ((tile.first - origin_x) 
+                + (tile.second - origin_z) * tpc);
+        };
+        out.assign(tpc * tpc, UINT64_MAX);
+        out[index_of(from)] = 0;
+        std::vector<std::pair<u64, NodeId>> open = { { 0, from } };
+        std::vector<std::pair<NodeId, u64>> next;
+        while(!open.empty()) {
+            std::pop_heap(open.begin(), open.end(), std::greater<>());
+            auto [tile_dist, tile] = open.back();
+            open.pop_back();
+            if(tile_dist > out[index_of(tile)]) { continue; }
+            this->collect_next_nodes(std::nullopt, tile, next);
+            for(auto [neigh, step_dist]: next) {
+                bool in_chunk = neigh.first >= origin_x 
+                    && neigh.first < origin_x + tpc
+                    && neigh.second >= origin_z 
+                    && neigh.second < origin_z + tpc;
+                if(!in_chunk) { continue; }
+                u64 neigh_dist = tile_dist + step_dist;
+                u64& known_dist = out[index_of(neigh)];
+                if(neigh_dist >= known_dist) { continue; }
+                known_dist = neigh_dist;
+                open.push_back({ neigh_dist, neigh });
+                std::push_heap(open.begin(), open.end(), std::greater<>());
+            }
+            next.clear();
+        }
+    }
+
+    void TileNetwork::compute_passable_area(
+        u64 min_x, u64 min_z, u64 max_x, u64 max_z
+    ) {
+        for(u64 z = min_z; z <= max_z; z += 1) {
+            for(u64 x = min_x; x <= max_x; x += 1) {
+                this->passability->set({ x, z }, this->compute_passable({ x, z }));
+            }
+        }
+    }
+
+    void TileNetwork::build_chunk_entrances(u64 chunk_x, u64 chunk_z) {
+        u64 tpc = this->terrain->tiles_per_chunk();
+        u64 min_x = chunk_x * tpc;
+        u64 min_z = chunk_z * tpc;
+        u64 max_x = std::min(min_x + tpc, this->terrain->width_in_tiles()) - 1;
+        u64 max_z = std::min(min_z + tpc, this->terrain->height_in_tiles()) - 1;
+        u64 chunk_i = chunk_x + chunk_z * this->terrain->width_in_chunks();
+        ChunkEntranceGraph::Chunk& chunk = this->chunk_graph.chunks[chunk_i];
+        chunk.entrances.clear();
+        // Each run of crossable tiles along a border becomes a single 
+        // entrance in the middle of the run. Both chunks sharing a border
+        // walk it in the same direction, meaning they agree on entrances.
+        auto add_border = [&](
+            u64 start_x, u64 start_z, u64 along_x, u64 along_z, u64 length,
+            i64 across_x, i64 across_z
+        ) {
+            u64 run_start = 0;
+            u64 run_length = 0;
+            for(u64 i = 0; i <= length; i += 1) {
+                bool crossable = false;
+                if(i < length) {
+                    NodeId tile = { 
+                        start_x + along_x * i, start_z + along_z * i 
+                    };
+                    NodeId partner = {
+                        (u64) ((i64) tile.first + across_x),
+                        (u64) ((i64) tile.second + across_z)
+                    };
+                    crossable = this->is_passable(tile) 
+                        && this->is_passable(partner);
+                }
+                if(crossable) {
+                    if(run_length == 0) { run_start = i; }
+                    run_length += 1;
+                    continue;
+                }
+                if(run_length == 0) { continue; }
+                u64 middle = run_start + run_length / 2;
+                NodeId tile = { 
+                    start_x + along_x * middle, start_z + along_z * middle 
+                };
+                NodeId partner = {
+                    (u64) ((i64) tile.first + across_x),
+                    (u64) ((i64) tile.second + across_z)
+                };
+                chunk.entrances.push_back({ tile, partner });
+                run_length = 0;
+            }
+        };
+        u64 width = max_x - min_x + 1;
+        u64 height = max_z - min_z + 1;
+        if(min_z > 0) {
+            add_border(min_x, min_z, 1, 0, width, 0, -1);
+        }
+        if(max_z + 1 < this->terrain->height_in_tiles()) {
+            add_border(min_x, max_z, 1, 0, width, 0, +1);
+        }
+        if(min_x > 0) {
+            add_border(min_x, min_z, 0, 1, height, -1, 0);
+        }
+        if(max_x + 1 < this->terrain->width_in_tiles()) {
+            add_border(max_x, min_z, 0, 1, height, +1, 0);
+        }
+        // find the cost between each pair of entrances
+        size_t entrance_c = chunk.entrances.size();
+        chunk.costs.resize(entrance_c * entrance_c);
+        std::vector<u64> dist;
+        for(size_t from_i = 0; from_i < entrance_c; from_i += 1) {
+            NodeId from = chunk.entrances[from_i].tile;
+            this->chunk_distances(chunk_x, chunk_z, from, dist);
+            for(size_t to_i = 0; to_i < entrance_c; to_i += 1) {
+                auto [to_x, to_z] = chunk.entrances[to_i].tile;
+                chunk.costs[from_i * entrance_c + to_i] 
+                    = dist[(to_x - min_x) + (to_z - min_z) * tpc];
+            }
+        }
+    }
+
+    void TileNetwork::reset() {
+        // distance fields are kept, but only used again once they have been
+        // rebuilt for the next network generation
+        u64 width_chunks = this->terrain->width_in_chunks();
+        u64 height_chunks = this->terrain->height_in_chunks();
+        u64 chunk_c = width_chunks * height_chunks;
+        std::vector<ChunkEntranceGraph::Chunk>& chunks = this->chunk_graph.chunks;
+        u64 width = this->terrain->width_in_tiles();
+        u64 height = this->terrain->height_in_tiles();
+        this->search_states.resize(width, height);
+        bool full_rebuild = this->modified_areas.empty() 
+            || chunks.size() != chunk_c
+            || this->passability == nullptr
+            || this->passability->width != width
+            || this->passability->height != height;
+        if(full_rebuild) {
+            this->passability = std::make_shared<TilePassability>(width, height);
+            this->compute_passable_area(0, 0, width - 1, height - 1);
+            chunks.resize(chunk_c);
+            for(u64 chunk_x = 0; chunk_x < width_chunks; chunk_x += 1) {
+                for(u64 chunk_z = 0; chunk_z < height_chunks; chunk_z += 1) {
+                    this->build_chunk_entrances(chunk_x, chunk_z);
+                }
+            }
+            this->modified_areas.clear();
+            return;
+        }
+        // searches in the background may still be using the current instance
+        if(this->passability.use_count() > 1) {
+            this->passability = std::make_shared<TilePassability>(
+                *this->passability
+            );
+        }
+        for(const ModifiedArea& area: this->modified_areas) {
+            this->compute_passable_area(
+                area.min_x, area.min_z, area.max_x, area.max_z
+            );
+        }
+        // Entrances of a chunk also depend on the tiles of its neighbours,
+        // so these get rebuilt as well.
+        u64 tpc = this->terrain->tiles_per_chunk();
+        std::vector<bool> rebuilt = std::vector<bool>(chunk_c, false);
+        for(const ModifiedArea& area: this->modified_areas) {
+            u64 min_ch_x = area.min_x / tpc;
+            u64 min_ch_z = area.min_z / tpc;
+            min_ch_x = min_ch_x > 0? min_ch_x - 1 : 0;
+            min_ch_z = min_ch_z > 0? min_ch_z - 1 : 0;
+            u64 max_ch_x = std::min(area.max_x / tpc + 1, width_chunks - 1);
+            u64 max_ch_z = std::min(area.max_z / tpc + 1, height_chunks - 1);
+            for(u64 chunk_x = min_ch_x; chunk_x <= max_ch_x; chunk_x += 1) {
+                for(u64 chunk_z = min_ch_z; chunk_z <= max_ch_z; chunk_z += 1) {
+                    u64 chunk_i = chunk_x + chunk_z * width_chunks;
+                    if(rebuilt[chunk_i]) { continue; }
+                    this->build_chunk_entrances(chunk_x, chunk_z);
+                    rebuilt[chunk_i] = true;
+                }
+            }
+        }
+        this->modified_areas.clear();
+    }
+
+    bool TileNetwork::restrict_search_area(NodeId start, ComplexId target) {
+        ChunkEntranceGraph& graph = this->chunk_graph;
+        u64 tpc = this->terrain->tiles_per_chunk();
+        u64 width_chunks = this->terrain->width_in_chunks();
+        u64 height_chunks = this->terrain->height_in_chunks();
+        if(graph.chunks.size() != width_chunks * height_chunks) { return false; }
+        // collect all chunks that may contain tiles at the target
+        graph.goal_chunks.clear();
+        for_each_target_area(*this, target, [&](
+            u64 min_x, u64 min_z, u64 max_x, u64 max_z
+        ) {
+            for(u64 chunk_x = min_x / tpc; chunk_x <= max_x / tpc; chunk_x += 1) {
+                for(u64 chunk_z = min_z / tpc; chunk_z <= max_z / tpc; chunk_z += 1) {
+                    u64 chunk_i = chunk_x + chunk_z * width_chunks;
+                    bool is_known = std::find(
+                        graph.goal_chunks.begin(), graph.goal_chunks.end(), 
+                        chunk_i
+                    ) != graph.goal_chunks.end();
+                    if(!is_known) { graph.goal_chunks.push_back(chunk_i); }
+                }
+            }
+        });
+        if(graph.goal_chunks.empty()) { return false; }
+        // short routes are cheap enough to not need planning
+        u64 start_ch_x = start.first / tpc;
+        u64 start_ch_z = start.second / tpc;
+        for(u64 chunk_i: graph.goal_chunks) {
+            u64 goal_ch_x = chunk_i % width_chunks;
+            u64 goal_ch_z = chunk_i / width_chunks;
+            u64 dx = std::max(start_ch_x, goal_ch_x) 
+                - std::min(start_ch_x, goal_ch_x);
+            u64 dz = std::max(start_ch_z, goal_ch_z) 
+                - std::min(start_ch_z, goal_ch_z);
+            if(dx <= 1 && dz <= 1) { return false; }
+        }
+        // connect the start to the entrances of its chunk
+        graph.start = start;
+        graph.start_edges.clear();
+        std::vector<u64> dist;
+        this->chunk_distances(start_ch_x, start_ch_z, start, dist);
+        const ChunkEntranceGraph::Chunk& start_chunk
+            = graph.chunks[start_ch_x + start_ch_z * width_chunks];
+        for(const ChunkEntranceGraph::Entrance& entrance: start_chunk.entrances) {
+            auto [ex, ez] = entrance.tile;
+            u64 entrance_dist = dist[
+                (ex - start_ch_x * tpc) + (ez - start_ch_z * tpc) * tpc
+            ];
+            if(entrance_dist == UINT64_MAX) { continue; }
+            graph.start_edges.push_back({ entrance.tile, entrance_dist });
+        }
+        std::optional<AgentPath<ChunkEntranceGraph>> route
+            = AgentPath<ChunkEntranceGraph>::find(graph, start, target);
+        if(!route.has_value()) { return false; }
+        // restrict to the chunks along the route and all their neighbours
+        this->search_area.assign(width_chunks * height_chunks, false);
+        auto include_around = [&](NodeId tile) {
+            u64 chunk_x = tile.first / tpc;
+            u64 chunk_z = tile.second / tpc;
+            u64 min_ch_x = chunk_x > 0? chunk_x - 1 : 0;
+            u64 min_ch_z = chunk_z > 0? chunk_z - 1 : 0;
+            u64 max_ch_x = std::min(chunk_x + 1, width_chunks - 1);
+            u64 max_ch_z = std::min(chunk_z + 1, height_chunks - 1);
+            for(u64 ch_x = min_ch_x; ch_x <= max_ch_x; ch_x += 1) {
+                for(u64 ch_z = min_ch_z; ch_z <= max_ch_z; ch_z += 1) {
+                    this->search_area[ch_x + ch_z * width_chunks] = true;
+                }
+            }
+        };
+        include_around(start);
+        for(NodeId point: route->points) { include_around(point); }
+        for(u64 chunk_i: graph.goal_chunks) {
+            this->search_area[chunk_i] = true;
+        }
+        this->search_area_active = true;
+        return true;
+    }
+
+    const TileNetwork::DistanceField* TileNetwork::distance_field_to(
+        ComplexId target
+    ) {
+        this->distance_field_requests += 1;
+        std::span<const std::pair<std::pair<u64, u64>, Complex::Member>> members
+            = this->complexes->get(target).get_members();
+        auto field = std::find_if(
+            this->distance_fields.begin(), this->distance_fields.end(),
+            [&](const auto& f) { return f.target.index == target.index; }
+        );
+        if(field == this->distance_fields.end()) {
+            if(this->distance_fields.size() >= max_distance_fields) {
+                // replace the field that hasn't been requested for the longest
+                field = std::min_element(
+                    this->distance_fields.begin(), this->distance_fields.end(),
+                    [](const auto& a, const auto& b) {
+                        return a.last_request < b.last_request;
+                    }
+                );
+                *field = DistanceField();
+            } else {
+                field = this->distance_fields.insert(
+                    this->distance_fields.end(), DistanceField()
+                );
+            }
+            field->target = target;
+        }
+        bool members_match = field->members.size() == members.size()
+            && std::equal(
+                members.begin(), members.end(), field->members.begin(),
+                [](const auto& m, const auto& p) { return m.first == p; }
+            );
+        if(!members_match) {
+            field->members.clear();
+            for(const auto& member: members) {
+                field->members.push_back(member.first);
+            }
+            field->request_count = 0;
+            field->dist.clear();
+            field->build = nullptr;
+        }
+        field->request_count += 1;
+        field->last_request = this->distance_field_requests;
+        // take the distances of a finished build, unless the network has
+        // been reset since it was started
+        if(field->build != nullptr && field->build->completed) {
+            if(field->build->generation == this->generation) {
+                field->dist = std::move(field->build->dist);
+                field->generation = field->build->generation;
+            }
+            field->build = nullptr;
+        }
+        if(field->generation != this->generation) { field->dist.clear(); }
+        if(!field->dist.empty()) { return &*field; }
+        // a single request is answered faster by a regular search
+        bool build_running = field->build != nullptr
+            && field->build->generation == this->generation;
+        if(field->request_count >= 2 && !build_running) {
+            this->build_distance_field(*field);
+        }
+        return nullptr;
+    }
+
+    void TileNetwork::build_distance_field(DistanceField& field) {
+        std::shared_ptr<const TileSearchSnapshot> snapshot
+            = this->snapshot_target(field.target);
+        auto build = std::make_shared<DistanceFieldBuild>(this->generation);
+        field.build = build;
+        engine::WorkerPool::shared().submit([build, snapshot]() {
+            build->dist = TileSnapshotNetwork::distances(*snapshot);
+            build->completed = true;
+        });
+    }
+
+    bool TileNetwork::follow_distance_field(
+        const DistanceField& field, NodeId start, std::vector<NodeId>& out
+    ) {
+        u64 width = this->terrain->width_in_tiles();
+        if(this->node_at_target(start, field.target)) { return true; }
+        NodeId current = start;
+        std::vector<std::pair<NodeId, u64>> next;
+        for(;;) {
+            this->collect_next_nodes(std::nullopt, current, next);
+            u64 best_dist = UINT64_MAX;
+            std::optional<NodeId> best = std::nullopt;
+            for(auto [neigh, step_dist]: next) {
+                u32 neigh_dist = field.dist[neigh.first + neigh.second * width];
+                if(neigh_dist == UINT32_MAX) { continue; }
+                u64 total_dist = (u64) neigh_dist + step_dist;
+                if(total_dist >= best_dist) { continue; }
+                best_dist = total_dist;
+                best = neigh;
+            }
+            next.clear();
+            if(!best.has_value()) { return false; }
+            out.push_back(*best);
+            if(field.dist[best->first + best->second * width] == 0) { 
+                return true; 
+            }
+            current = *best;
+        }
+    }
+
+    std::shared_ptr<TileSearchSnapshot> TileNetwork::snapshot_target(
+        ComplexId target
+    ) {
+        auto snapshot = std::make_shared<TileSearchSnapshot>();
+        snapshot->passability = this->passability;
+        snapshot->target = target;
+        const Complex& complex = this->complexes->get(target);
+        for(const auto& [member_pos, member]: complex.get_members()) {
+            (void) member;
+            auto [bx, bz] = member_pos;
+            const Building* building = this->terrain
+                ->building_at((i64) bx, (i64) bz);
+            if(building == nullptr) { continue; }
+            const Building::TypeInfo& building_type = Building::types()
+                .at((size_t) building->type);
+            snapshot->footprints.push_back(TargetFootprint(
+                bx, bz, 
+                bx + building_type.width - 1, bz + building_type.height - 1
+            ));
+        }
+        snapshot->max_target_dist = this->max_target_dist;
+        snapshot->tiles_per_chunk = this->terrain->tiles_per_chunk();
+        snapshot->width_chunks = this->terrain->width_in_chunks();
+        snapshot->uniform_costs = this->uniform_costs();
+        return snapshot;
+    }
+
+    std::shared_ptr<const TileSearchSnapshot> TileNetwork::snapshot_search(
+        NodeId start, ComplexId target
+    ) {
+        std::shared_ptr<TileSearchSnapshot> snapshot
+            = this->snapshot_target(target);
+        if(this->restrict_search_area(start, target)) {
+            snapshot->search_area = this->search_area;
+            this->clear_search_area();
+        }
+        return snapshot;
+    }
+
+
+
+    // Network for searching the way from some tile back onto a path.
+    struct PathRejoinNetwork {
+        using NodeId = TileNetwork::NodeId;
+        using NodeIdHash = TileNetwork::NodeIdHash;
+        using SearchStates = TileNetwork::SearchStates;
+
+        TileNetwork& network;
+        SearchStates& search_states;
+        std::vector<OpenSearchNode<NodeId>>& search_open;
+        std::vector<std::pair<NodeId, u64>>& search_connected;
+        std::span<const NodeId> rejoined;
+
+        PathRejoinNetwork(TileNetwork& network, std::span<const NodeId> rejoined):
+            network(network), search_states(network.search_states),
+            search_open(network.search_open), 
+            search_connected(network.search_connected),
+            rejoined(rejoined) {}
+
+        void collect_next_nodes(
+            std::optional<NodeId> prev, NodeId node, 
+            std::vector<std::pair<NodeId, u64>>& out
+        ) {
+            this->network.collect_next_nodes(prev, node, out);
+        }
+
+        u64 node_target_dist(NodeId node, ComplexId target) const {
+            (void) target;
+            u64 closest = UINT64_MAX;
+            for(NodeId point: this->rejoined) {
+                auto footprint = TargetFootprint(
+                    point.first, point.second, point.first, point.second
+                );
+                closest = std::min(
+                    closest, footprint.manhattan_dist(node.first, node.second)
+                );
+            }
+            return closest;
+        }
+
+        bool node_at_target(NodeId node, ComplexId target) const {
+            (void) target;
+            return std::find(this->rejoined.begin(), this->rejoined.end(), node)
+                != this->rejoined.end();
+        }
+    };
+
+    static const size_t max_rejoined_points = 32;
+
+    bool TileNetwork::repair_path(
+        NodeId start, std::vector<NodeId>& points, size_t from_i, 
+        ComplexId target
+    ) {
+        if(from_i >= points.size()) { return false; }
+        if(!this->node_at_target(points.back(), target)) { return false; }
+        std::optional<size_t> first_blocked = std::nullopt;
+        size_t last_blocked = 0;
+        for(size_t point_i = from_i; point_i < points.size(); point_i += 1) {
+            if(this->is_passable(points[point_i])) { continue; }
+            if(!first_blocked.has_value()) { first_blocked = point_i; }
+            last_blocked = point_i;
+        }
+        if(!first_blocked.has_value()) { return true; }
+        size_t rejoined_start = last_blocked + 1;
+        size_t rejoined_end = std::min(
+            rejoined_start + max_rejoined_points, points.size()
+        );
+        if(rejoined_start >= rejoined_end) { return false; }
+        // only search near the affected section of the path
+        u64 tpc = this->terrain->tiles_per_chunk();
+        u64 width_chunks = this->terrain->width_in_chunks();
+        u64 height_chunks = this->terrain->height_in_chunks();
+        this->search_area.assign(width_chunks * height_chunks, false);
+        auto include_around = [&](NodeId tile) {
+            u64 chunk_x = tile.first / tpc;
+            u64 chunk_z = tile.second / tpc;
+            u64 min_ch_x = chunk_x > 0? chunk_x - 1 : 0;
+            u64 min_ch_z = chunk_z > 0? chunk_z - 1 : 0;
+            u64 max_ch_x = std::min(chunk_x + 1, width_chunks - 1);
+            u64 max_ch_z = std::min(chunk_z + 1, height_chunks - 1);
+            for(u64 ch_x = min_ch_x; ch_x <= max_ch_x; ch_x += 1) {
+                for(u64 ch_z = min_ch_z; ch_z <= max_ch_z; ch_z += 1) {
+                    this->search_area[ch_x + ch_z * width_chunks] = true;
+                }
+            }
+        };
+        include_around(start);
+        for(size_t point_i = from_i; point_i < rejoined_end; point_i += 1) {
+            include_around(points[point_i]);
+        }
+        this->search_area_active = true;
+        auto rejoined = std::span<const NodeId>(
+            points.begin() + rejoined_start, points.begin() + rejoined_end
+        );
+        auto rejoin_network = PathRejoinNetwork(*this, rejoined);
+        std::optional<AgentPath<PathRejoinNetwork>> detour
+            = AgentPath<PathRejoinNetwork>::find(rejoin_network, start, target);
+        this->clear_search_area();
+        if(!detour.has_value() || detour->points.empty()) { return false; }
+        // replace everything up to the rejoined point with the detour
+        auto rejoined_at = std::find(
+            points.begin() + rejoined_start, points.begin() + rejoined_end,
+            detour->points.back()
+        );
+        points.erase(points.begin() + from_i, rejoined_at + 1);
+        points.insert(
+            points.begin() + from_i, 
+            detour->points.begin(), detour->points.end()
+        );
+        return true;
+    }
+
+}
@@ -1,11 +1,68 @@
 
 #pragma once
 
+#include <engine/workers.hpp>
 #include "agent.hpp"
 #include "terrain.hpp"
 
 namespace houseofatmos::world {
 
+    // Search states for tile networks, stored in flat arrays indexed by
+    // tile. Instead of clearing the arrays between searches each state is
+    // stamped with the search generation it was last written by.
+    struct GridSearchStates {
+        using NodeId = std::pair<u64, u64>;
+        using State = NodeSearchState<NodeId>;
+
+        private:
+        u64 width = 0;
+        u64 height = 0;
+        u32 generation = 0;
+        std::vector<u32> generations;
+        std::vector<State> states;
+
+        size_t index_of(const NodeId& node) const {
+            return (size_t) (node.first + node.second * this->width);
+        }
+
+        public:
+        void resize(u64 width, u64 height) {
+            if(width == this->width && height == this->height) { return; }
+            this->width = width;
+            this->height = height;
+            this->generations.assign(width * height, 0);
+            this->states.resize(width * height);
+            this->generation = 0;
+        }
+
+        void begin_search() {
+            this->generation += 1;
+            if(this->generation == 0) { // wrapped around
+                std::fill(this->generations.begin(), this->generations.end(), 0);
+                this->generation = 1;
+            }
+        }
+
+        State& at(const NodeId& node) {
+            size_t i = this->index_of(node);
+            if(this->generations[i] != this->generation) {
+                engine::error("Search state of node was never inserted");
+            }
+            return this->states[i];
+        }
+
+        std::pair<State*, bool> insert(const NodeId& node) {
+            size_t i = this->index_of(node);
+            State* state = &this->states[i];
+            if(this->generations[i] == this->generation) {
+                return { state, false };
+            }
+            this->generations[i] = this->generation;
+            *state = State(UINT64_MAX, 0, std::nullopt);
+            return { state, true };
+        }
+    };
+
     struct TileNetworkNode {
         using NodeId = std::pair<u64, u64>;
         struct NodeIdHash {
@@ -15,47 +72,294 @@ namespace houseofatmos::world {
                 return xh ^ (zh + 0x9e3779b9 + (xh << 6) + (xh >> 2));
             }
         };
+        using SearchStates = GridSearchStates;
+    };
+
+    // Passability of each tile of a tile network. Instances may be shared 
+    // with searches running in the background and must not be modified
+    // while that is the case.
+    struct TilePassability {
+        using NodeId = TileNetworkNode::NodeId;
+
+        static inline const u64 cost_ortho = 10;
+        static inline const u64 cost_daigo = 14;
+
+        u64 width, height;
+        std::vector<u64> bits; // one bit per tile, set if passable
+
+        TilePassability(u64 width, u64 height): width(width), height(height),
+            bits(std::vector<u64>((size_t) ((width * height + 63) / 64), 0)) {}
+
+        bool at(NodeId tile) const {
+            size_t tile_i = (size_t) (tile.first + tile.second * this->width);
+            return (this->bits[tile_i / 64] >> (tile_i % 64)) & 1;
+        }
+
+        void set(NodeId tile, bool is_passable) {
+            size_t tile_i = (size_t) (tile.first + tile.second * this->width);
+            u64 mask = (u64) 1 << (tile_i % 64);
+            if(is_passable) { this->bits[tile_i / 64] |= mask; } 
+            else { this->bits[tile_i / 64] &= ~mask; }
+        }
+
+        // Collects all passable neighbours of the given tile. If 'area' is
+        // given only neighbours inside of chunks marked in it are included.
+        void collect_neighbours(
+            NodeId tile, const std::vector<bool>* area,
+            u64 tiles_per_chunk, u64 width_chunks,
+            std::vector<std::pair<NodeId, u64>>& out
+        ) const {
+            auto [x, z] = tile;
+            u64 left = x > 0? x - 1 : 0;
+            u64 right = std::min(x + 1, this->width - 1);
+            u64 top = z > 0? z - 1 : 0;
+            u64 bottom = std::min(z + 1, this->height - 1);
+            for(u64 nx = left; nx <= right; nx += 1) {
+                for(u64 nz = top; nz <= bottom; nz += 1) {
+                    NodeId neighbor = { nx, nz };
+                    if(nx == x && nz == z) { continue; }
+                    bool in_area = area == nullptr || (*area)[
+                        nx / tiles_per_chunk 
+                            + nz / tiles_per_chunk * width_chunks
+                    ];
+                    if(!in_area) { continue; }
+                    if(!this->at(neighbor)) { continue; }
+                    bool is_diagonal = nx != x && nz != z;
+                    u64 cost = is_diagonal? cost_daigo : cost_ortho;
+                    out.push_back({ neighbor, cost });
+                }
+            }
+        }
+    };
+
+    // Area covered by a building that agents may travel to.
+    struct TargetFootprint {
+        u64 start_x, start_z;
+        u64 end_x, end_z; // last tile still inside the building
+
+        u64 manhattan_dist(u64 x, u64 z) const {
+            u64 dx = x < this->start_x? this->start_x - x // left of building
+                : x > this->end_x? x - this->end_x        // right of building
+                : 0;                                      // inside on X axis
+            u64 dz = z < this->start_z? this->start_z - z // top of building
+                : z > this->end_z? z - this->end_z        // below building
+                : 0;                                      // inside on Z axis
+            return dx + dz;
+        }
+    };
+
+    // Copy of everything needed to search for a path on a tile network,
+    // which allows the search to be done in the background.
+    struct TileSearchSnapshot {
+        std::shared_ptr<const TilePassability> passability;
+        ComplexId target;
+        std::vector<TargetFootprint> footprints; // in member order
+        u64 max_target_dist;
+        u64 tiles_per_chunk;
+        u64 width_chunks;
+        // chunks the search shall be restricted to, empty if unrestricted
+        std::vector<bool> search_area;
+        bool uniform_costs;
+    };
+
+    // Adapter for running 'AgentPath::find' on a 'TileSearchSnapshot'.
+    struct TileSnapshotNetwork {
+        using NodeId = TileNetworkNode::NodeId;
+        using NodeIdHash = TileNetworkNode::NodeIdHash;
+        using SearchStates = GridSearchStates;
+
+        const TileSearchSnapshot* snapshot = nullptr;
+        bool restricted = false;
+        // If set, only jump points are collected as next nodes, meaning the
+        // found path needs to be expanded using 'expand_jumps'.
+        bool jump = false;
+        // tiles outside of this area are never at the target
+        u64 target_min_x = 0, target_min_z = 0;
+        u64 target_max_x = UINT64_MAX, target_max_z = UINT64_MAX;
+
+        SearchStates search_states;
+        std::vector<OpenSearchNode<NodeId>> search_open;
+        std::vector<std::pair<NodeId, u64>> search_connected;
+
+        // Finds a path to the target of the snapshot. The search state is 
+        // kept per thread, meaning this may be called by multiple threads.
+        static std::optional<std::vector<NodeId>> search(
+            const TileSearchSnapshot& snapshot, NodeId start
+        );
+
+        // Computes the distance (in path cost) from each tile to the target 
+        // of the snapshot, UINT32_MAX if unreachable. Search area is ignored.
+        static std::vector<u32> distances(const TileSearchSnapshot& snapshot);
+
+        void collect_next_nodes(
+            std::optional<NodeId> prev, NodeId node, 
+            std::vector<std::pair<NodeId, u64>>& out
+        ) const {
+            if(this->jump) {
+                this->collect_jump_points(prev, node, out);
+                return;
+            }
+            this->snapshot->passability->collect_neighbours(
+                node, this->restricted? &this->snapshot->search_area : nullptr,
+                this->snapshot->tiles_per_chunk, this->snapshot->width_chunks, 
+                out
+            );
+        }
+
+        u64 node_target_dist(NodeId node, ComplexId target) const;
+
+        bool node_at_target(NodeId node, ComplexId target) const {
+            return this->node_target_dist(node, target) 
+                <= this->snapshot->max_target_dist;
+        }
+
+        private:
+        void bound_target();
+        bool walkable(i64 x, i64 z) const;
+        std::optional<NodeId> jump_from(NodeId from, i64 dx, i64 dz) const;
+        void collect_jump_points(
+            std::optional<NodeId> prev, NodeId node, 
+            std::vector<std::pair<NodeId, u64>>& out
+        ) const;
+        static void expand_jumps(NodeId start, std::vector<NodeId>& points);
     };
 
+    struct ChunkEntranceNode {
+        using NodeId = TileNetworkNode::NodeId;
+        using NodeIdHash = TileNetworkNode::NodeIdHash;
+        using SearchStates = HashedSearchStates<NodeId, NodeIdHash>;
+    };
+
+    // Abstract graph over a tile network, used to plan long routes.
+    // Nodes are tiles on chunk borders where agents can cross into the
+    // neighbouring chunk. Edges are either such crossings or the cheapest
+    // path between two entrances of the same chunk.
+    struct ChunkEntranceGraph: AgentNetwork<ChunkEntranceNode> {
+
+        struct Entrance {
+            NodeId tile;
+            NodeId partner; // tile on the other side of the chunk border
+        };
+
+        struct Chunk {
+            std::vector<Entrance> entrances;
+            // cost from each entrance to each other entrance of the chunk,
+            // UINT64_MAX if not reachable inside of the chunk
+            std::vector<u64> costs;
+        };
+
+        std::vector<Chunk> chunks;
+
+        // the following are set up for each search
+        NodeId start;
+        std::vector<std::pair<NodeId, u64>> start_edges;
+        std::vector<u64> goal_chunks;
+
+        ChunkEntranceGraph(const Terrain* terrain, ComplexBank* complexes):
+            AgentNetwork(complexes, terrain, "") {}
+
+        ChunkEntranceGraph(ChunkEntranceGraph&& other) noexcept = default;
+        ChunkEntranceGraph& operator=(
+            ChunkEntranceGraph&& other
+        ) noexcept = default;
+
+        u64 chunk_index_of(NodeId tile) const {
+            u64 tpc = this->terrain->tiles_per_chunk();
+            return tile.first / tpc 
+                + tile.second / tpc * this->terrain->width_in_chunks();
+        }
+
+        void collect_next_nodes(
+            std::optional<NodeId> prev, NodeId node, 
+            std::vector<std::pair<NodeId, u64>>& out
+        ) override;
+
+        u64 node_target_dist(NodeId node, ComplexId target) override;
+
+        bool node_at_target(NodeId node, ComplexId target) override;
+
+    };
+
+
     struct TileNetwork: AgentNetwork<TileNetworkNode> {
 
+        // Distances being computed for a distance field in the background.
+        struct DistanceFieldBuild {
+            u64 generation; // of the network the build was started for
+            std::vector<u32> dist;
+            // only read 'dist' once this is set
+            std::atomic<bool> completed = false;
+
+            DistanceFieldBuild(u64 generation): generation(generation) {}
+        };
+
+        // Distances (in path cost) from each tile to a specific target, shared
+        // by all agents travelling there. Only built (in the background) once
+        // the same target has been requested more than once.
+        struct DistanceField {
+            ComplexId target;
+            // member positions of the target at the time of creation
+            std::vector<std::pair<u64, u64>> members;
+            u64 request_count = 0;
+            u64 last_request = 0;
+            u64 generation = 0; // of the network the distances are valid for
+            std::vector<u32> dist; // UINT32_MAX if unreachable, empty if unbuilt
+            std::shared_ptr<DistanceFieldBuild> build; // nullptr if none running
+        };
+
+        static inline const size_t max_distance_fields = 16;
+
         u64 max_target_dist;
+        ChunkEntranceGraph chunk_graph;
 
+        private:
+        std::shared_ptr<TilePassability> passability;
+        std::vector<DistanceField> distance_fields;
+        u64 distance_field_requests = 0;
+
+        // chunks that searches are currently restricted to
+        std::vector<bool> search_area;
+        bool search_area_active = false;
+
+        public:
         TileNetwork(
             const Terrain* terrain, ComplexBank* complexes, 
             std::string local_lost_msg, u64 max_target_dist
         ): AgentNetwork(complexes, terrain, local_lost_msg), 
-            max_target_dist(max_target_dist) {}
+            max_target_dist(max_target_dist),
+            chunk_graph(ChunkEntranceGraph(terrain, complexes)) {}
 
         TileNetwork(TileNetwork&& other) noexcept = default;
         TileNetwork& operator=(TileNetwork&& other) noexcept = default;
 
-        virtual bool is_passable(NodeId node) = 0;
+        // Computes if the given tile is passable from the terrain. 
+        // Results are cached on reset, use 'is_passable' to read them.
+        virtual bool compute_passable(NodeId node) = 0;
 
+        bool is_passable(NodeId node) const {
+            return this->passability->at(node);
+        }
 
-        static inline const u64 cost_ortho = 10;
-        static inline const u64 cost_daigo = 14;
+        // Networks where the cost of moving between tiles only depends on 
+        // the direction of the move may be searched using jump point search,
+        // which skips over open areas instead of expanding each tile.
+        virtual bool uniform_costs() const { return false; }
+
+
+        static inline const u64 cost_ortho = TilePassability::cost_ortho;
+        static inline const u64 cost_daigo = TilePassability::cost_daigo;
 
         void collect_next_nodes(
             std::optional<NodeId> prev, NodeId node, 
             std::vector<std::pair<NodeId, u64>>& out
         ) override {
             (void) prev;
-            auto [x, z] = node;
-            u64 left = x > 0? x - 1 : 0;
-            u64 right = std::min(x + 1, this->terrain->width_in_tiles() - 1);
-            u64 top = z > 0? z - 1 : 0;
-            u64 bottom = std::min(z + 1, this->terrain->height_in_tiles() - 1);
-            for(u64 nx = left; nx <= right; nx += 1) {
-                for(u64 nz = top; nz <= bottom; nz += 1) {
-                    NodeId neighbor = { nx, nz };
-                    if(nx == x && nz == z) { continue; }
-                    if(!this->is_passable(neighbor)) { continue; }
-                    bool is_diagonal = nx != x && nz != z;
-                    u64 cost = is_diagonal? cost_daigo : cost_ortho;
-                    out.push_back({ neighbor, cost });
-                }
-            }
+            this->passability->collect_neighbours(
+                node, this->search_area_active? &this->search_area : nullptr,
+                this->terrain->tiles_per_chunk(), 
+                this->terrain->width_in_chunks(),
+                out
+            );
         }
 
         u64 node_target_dist(NodeId node, ComplexId target) override {
@@ -69,16 +373,11 @@ namespace houseofatmos::world {
                 ->building_at((i64) bsx, (i64) bsz);
             const Building::TypeInfo& building_type = Building::types()
                 .at((size_t) building->type);
-            u64 bex = bsx + building_type.width - 1;
-            u64 bez = bsz + building_type.height - 1;
-            // distance on each individual axis
-            u64 dx = nx < bsx? bsx - nx // left of building
-                : nx > bex? nx - bex    // right of building
-                : 0;                    // on X axis inside building
-            u64 dz = nz < bsz? bsz - nz // top of building
-                : nz > bez? nz - bez    // below building
-                : 0;                    // on Z axis inside building
-            return dx + dz; // manhattan distance
+            auto footprint = TargetFootprint(
+                bsx, bsz,
+                bsx + building_type.width - 1, bsz + building_type.height - 1
+            );
+            return footprint.manhattan_dist(nx, nz);
         }
 
         bool node_at_target(NodeId node, ComplexId target) override {
@@ -86,15 +385,66 @@ namespace houseofatmos::world {
                 <= this->max_target_dist;
         }
 
+        void reset() override;
+
+        // Attempts to plan a route from 'start' to 'target' on the chunk
+        // entrance graph and restricts all following searches to the chunks
+        // along that route. Returns false if no restriction was applied.
+        bool restrict_search_area(NodeId start, ComplexId target);
+
+        void clear_search_area() { this->search_area_active = false; }
+
+        // Checks if the remaining part of the given path (starting at index
+        // 'from_i') is still passable and leads to the target. If sections
+        // of it have become impassable a detour around them is searched for
+        // near the path. Returns false if no usable path could be made.
+        bool repair_path(
+            NodeId start, std::vector<NodeId>& points, size_t from_i, 
+            ComplexId target
+        );
+
+        // Copies everything needed to search for a path from 'start' 
+        // to 'target' in the background.
+        std::shared_ptr<const TileSearchSnapshot> snapshot_search(
+            NodeId start, ComplexId target
+        );
+
+        // Returns the distance field for the given target, or nullptr if 
+        // there is none for the current network generation (yet).
+        const DistanceField* distance_field_to(ComplexId target);
+
+        // Writes the path from 'start' to the target of the given field to
+        // 'out' by always moving to the neighbour closest to the target.
+        // Returns false if the target can't be reached from 'start'.
+        bool follow_distance_field(
+            const DistanceField& field, NodeId start, std::vector<NodeId>& out
+        );
+
+        bool in_search_area(NodeId node) const {
+            return !this->search_area_active
+                || this->search_area[this->chunk_graph.chunk_index_of(node)];
+        }
+
         NodeId tile_of(const Vec<3>& position) const {
             Vec<3> tile = position / this->terrain->units_per_tile();
             u64 x = (u64) std::max(tile.x(), 0.0);
-            x = std::min(x, this->terrain->width_in_tiles());
+            x = std::min(x, this->terrain->width_in_tiles() - 1);
             u64 z = (u64) std::max(tile.z(), 0.0);
-            z = std::min(z, this->terrain->height_in_tiles());
+            z = std::min(z, this->terrain->height_in_tiles() - 1);
             return NodeId(x, z);
         }
 
+        private:
+        void chunk_distances(
+            u64 chunk_x, u64 chunk_z, NodeId from, std::vector<u64>& out
+        );
+        void compute_passable_area(
+            u64 min_x, u64 min_z, u64 max_x, u64 max_z
+        );
+        void build_chunk_entrances(u64 chunk_x, u64 chunk_z);
+        std::shared_ptr<TileSearchSnapshot> snapshot_target(ComplexId target);
+        void build_distance_field(DistanceField& field);
+
     };
 
 
@@ -141,11 +491,66 @@ namespace houseofatmos::world {
             return this->position;
         }
 
+        std::shared_ptr<PathRequest<Network>> request_path_to(
+            Network& network, ComplexId target
+        ) override {
+            this->next_point_i = 0;
+            auto start = network.tile_of(this->position);
+            auto request = std::make_shared<PathRequest<Network>>(
+                network.generation
+            );
+            const TileNetwork::DistanceField* field 
+                = network.distance_field_to(target);
+            if(field != nullptr) {
+                request->path = AgentPath<Network>();
+                bool found = network
+                    .follow_distance_field(*field, start, request->path->points);
+                if(!found) { request->path = std::nullopt; }
+                request->completed = true;
+                return request;
+            }
+            std::shared_ptr<const TileSearchSnapshot> snapshot
+                = network.snapshot_search(start, target);
+            engine::WorkerPool::shared().submit([request, snapshot, start]() {
+                auto points = TileSnapshotNetwork::search(*snapshot, start);
+                if(points.has_value()) {
+                    request->path = AgentPath<Network>();
+                    request->path->points = std::move(*points);
+                }
+                request->completed = true;
+            });
+            return request;
+        }
+
+        bool repair_path(Network& network) override {
+            std::optional<AgentPath<Network>>& path = this->current_path();
+            if(!path.has_value()) { return false; }
+            auto start = network.tile_of(this->position);
+            return network.repair_path(
+                start, path->points, this->next_point_i, 
+                this->next_stop().target
+            );
+        }
+
         std::optional<AgentPath<Network>> find_path_to(
             Network& network, ComplexId target
         ) override {
             this->next_point_i = 0;
             auto start = network.tile_of(this->position);
+            const TileNetwork::DistanceField* field 
+                = network.distance_field_to(target);
+            if(field != nullptr) {
+                auto path = AgentPath<Network>();
+                bool found = network
+                    .follow_distance_field(*field, start, path.points);
+                if(!found) { return std::nullopt; }
+                return path;
+            }
+            if(network.restrict_search_area(start, target)) {
+                auto path = AgentPath<Network>::find(network, start, target);
+                network.clear_search_area();
+                if(path.has_value()) { return path; }
+            }
             return AgentPath<Network>::find(network, start, target);
         }
 
@@ -0,0 +1,254 @@
+
+#include "tile_network.hpp"
+
+namespace houseofatmos::world {
+
+    std::optional<std::vector<TileSnapshotNetwork::NodeId>> 
+        TileSnapshotNetwork::search(
+            const TileSearchSnapshot& snapshot, NodeId start
+        ) {
+        if(snapshot.footprints.empty()) { return std::nullopt; }
+        static thread_local TileSnapshotNetwork network;
+        network.snapshot = &snapshot;
+        network.search_states.resize(
+            snapshot.passability->width, snapshot.passability->height
+        );
+        network.restricted = !snapshot.search_area.empty();
+        network.jump = snapshot.uniform_costs;
+        network.bound_target();
+        std::optional<AgentPath<TileSnapshotNetwork>> path 
+            = AgentPath<TileSnapshotNetwork>::find(network, start, snapshot.target);
+        if(!path.has_value() && network.restricted) {
+            network.restricted = false;
+            path = AgentPath<TileSnapshotNetwork>::find(
+                network, start, snapshot.target
+            );
+        }
+        network.snapshot = nullptr;
+        if(!path.has_value()) { return std::nullopt; }
+        if(network.jump) { expand_jumps(start, path->points); }
+        return std::move(path->points);
+    }
+
+    std::vector<u32> TileSnapshotNetwork::distances(
+        const TileSearchSnapshot& snapshot
+    ) {
+        const TilePassability& passability = *snapshot.passability;
+        u64 width = passability.width;
+        u64 height = passability.height;
+        auto dist = std::vector<u32>(width * height, UINT32_MAX);
+        auto network = TileSnapshotNetwork();
+        network.snapshot = &snapshot;
+        std::vector<std::pair<u32, NodeId>> open;
+        u64 reach = snapshot.max_target_dist;
+        for(const TargetFootprint& footprint: snapshot.footprints) {
+            u64 min_x = footprint.start_x > reach? footprint.start_x - reach : 0;
+            u64 min_z = footprint.start_z > reach? footprint.start_z - reach : 0;
+            u64 max_x = std::min(footprint.end_x + reach, width - 1);
+            u64 max_z = std::min(footprint.end_z + reach, height - 1);
+            for(u64 x = min_x; x <= max_x; x += 1) {
+                for(u64 z = min_z; z <= max_z; z += 1) {
+                    NodeId tile = { x, z };
+                    u32& tile_dist = dist[x + z * width];
+                    if(tile_dist == 0) { continue; }
+                    if(!network.node_at_target(tile, snapshot.target)) { 
+                        continue; 
+                    }
+                    if(!passability.at(tile)) { continue; }
+                    tile_dist = 0;
+                    open.push_back({ 0, tile });
+                }
+            }
+        }
+        // movement costs are symmetrical, which means that searching 
+        // outwards from the target results in the distances to it
+        std::vector<std::pair<NodeId, u64>> next;
+        std::make_heap(open.begin(), open.end(), std::greater<>());
+        while(!open.empty()) {
+            std::pop_heap(open.begin(), open.end(), std::greater<>());
+            auto [tile_dist, tile] = open.back();
+            open.pop_back();
+            if(tile_dist > dist[tile.first + tile.second * width]) { continue; }
+            passability.collect_neighbours(
+                tile, nullptr, snapshot.tiles_per_chunk, snapshot.width_chunks,
+                next
+            );
+            for(auto [neigh, step_dist]: next) {
+                u32 neigh_dist = tile_dist + (u32) step_dist;
+                u32& known_dist = dist[neigh.first + neigh.second * width];
+                if(neigh_dist >= known_dist) { continue; }
+                known_dist = neigh_dist;
+                open.push_back({ neigh_dist, neigh });
+                std::push_heap(open.begin(), open.end(), std::greater<>());
+            }
+            next.clear();
+        }
+        return dist;
+    }
+
+    void TileSnapshotNetwork::bound_target() {
+        u64 reach = this->snapshot->max_target_dist;
+        this->target_min_x = UINT64_MAX;
+        this->target_min_z = UINT64_MAX;
+        this->target_max_x = 0;
+        this->target_max_z = 0;
+        for(const TargetFootprint& footprint: this->snapshot->footprints) {
+            u64 min_x = footprint.start_x > reach? footprint.start_x - reach : 0;
+            u64 min_z = footprint.start_z > reach? footprint.start_z - reach : 0;
+            this->target_min_x = std::min(this->target_min_x, min_x);
+            this->target_min_z = std::min(this->target_min_z, min_z);
+            this->target_max_x = std::max(
+                this->target_max_x, footprint.end_x + reach
+            );
+            this->target_max_z = std::max(
+                this->target_max_z, footprint.end_z + reach
+            );
+        }
+    }
+
+    bool TileSnapshotNetwork::walkable(i64 x, i64 z) const {
+        const TilePassability& passability = *this->snapshot->passability;
+        bool in_bounds = x >= 0 && z >= 0
+            && (u64) x < passability.width && (u64) z < passability.height;
+        if(!in_bounds) { return false; }
+        if(this->restricted) {
+            u64 tpc = this->snapshot->tiles_per_chunk;
+            u64 chunk_i = (u64) x / tpc 
+                + (u64) z / tpc * this->snapshot->width_chunks;
+            if(!this->snapshot->search_area[chunk_i]) { return false; }
+        }
+        return passability.at({ (u64) x, (u64) z });
+    }
+
+    // Moves from 'from' in the given direction until reaching a tile that
+    // needs to be expanded - either a tile at the target or one with a 
+    // neighbour that can't be reached more cheaply without passing it.
+    std::optional<TileSnapshotNetwork::NodeId> TileSnapshotNetwork::jump_from(
+        NodeId from, i64 dx, i64 dz
+    ) const {
+        i64 x = (i64) from.first;
+        i64 z = (i64) from.second;
+        for(;;) {
+            x += dx;
+            z += dz;
+            if(!this->walkable(x, z)) { return std::nullopt; }
+            auto tile = NodeId((u64) x, (u64) z);
+            // most scanned tiles are far from the target, so only check 
+            // against the footprints of the target when close to it
+            bool near_target = (u64) x >= this->target_min_x 
+                && (u64) x <= this->target_max_x
+                && (u64) z >= this->target_min_z 
+                && (u64) z <= this->target_max_z;
+            bool at_target = near_target 
+                && this->node_at_target(tile, this->snapshot->target);
+            if(at_target) { return tile; }
+            if(dx != 0 && dz != 0) {
+                bool has_forced 
+                    = (this->walkable(x - dx, z + dz) && !this->walkable(x - dx, z))
+                    || (this->walkable(x + dx, z - dz) && !this->walkable(x, z - dz));
+                if(has_forced) { return tile; }
+                bool has_straight = this->jump_from(tile, dx, 0).has_value()
+                    || this->jump_from(tile, 0, dz).has_value();
+                if(has_straight) { return tile; }
+            } else if(dx != 0) {
+                bool has_forced 
+                    = (this->walkable(x + dx, z + 1) && !this->walkable(x, z + 1))
+                    || (this->walkable(x + dx, z - 1) && !this->walkable(x, z - 1));
+                if(has_forced) { return tile; }
+            } else {
+                bool has_forced 
+                    = (this->walkable(x + 1, z + dz) && !this->walkable(x + 1, z))
+                    || (this->walkable(x - 1, z + dz) && !this->walkable(x - 1, z));
+                if(has_forced) { return tile; }
+            }
+        }
+    }
+
+    void TileSnapshotNetwork::collect_jump_points(
+        std::optional<NodeId> prev, NodeId node, 
+        std::vector<std::pair<NodeId, u64>>& out
+    ) const {
+        i64 x = (i64) node.first;
+        i64 z = (i64) node.second;
+        std::array<std::pair<i64, i64>, 8> dirs;
+        size_t dir_c = 0;
+        if(!prev.has_value()) {
+            for(i64 dx = -1; dx <= 1; dx += 1) {
+                for(i64 dz = -1; dz <= 1; dz += 1) {
+                    if(dx == 0 && dz == 0) { continue; }
+                    dirs[dir_c++] = { dx, dz };
+                }
+            }
+        } else {
+            // only continue in the direction we came from, plus neighbours
+            // that would otherwise only be reachable through this tile
+            i64 dx = x > (i64) prev->first? 1 : x < (i64) prev->first? -1 : 0;
+            i64 dz = z > (i64) prev->second? 1 : z < (i64) prev->second? -1 : 0;
+            if(dx != 0 && dz != 0) {
+                dirs[dir_c++] = { dx, dz };
+                dirs[dir_c++] = { dx, 0 };
+                dirs[dir_c++] = { 0, dz };
+                if(!this->walkable(x - dx, z)) { dirs[dir_c++] = { -dx, dz }; }
+                if(!this->walkable(x, z - dz)) { dirs[dir_c++] = { dx, -dz }; }
+            } else if(dx != 0) {
+                dirs[dir_c++] = { dx, 0 };
+                if(!this->walkable(x, z + 1)) { dirs[dir_c++] = { dx, 1 }; }
+                if(!this->walkable(x, z - 1)) { dirs[dir_c++] = { dx, -1 }; }
+            } else {
+                dirs[dir_c++] = { 0, dz };
+                if(!this->walkable(x + 1, z)) { dirs[dir_c++] = { 1, dz }; }
+                if(!this->walkable(x - 1, z)) { dirs[dir_c++] = { -1, dz }; }
+            }
+        }
+        for(size_t dir_i = 0; dir_i < dir_c; dir_i += 1) {
+            auto [dx, dz] = dirs[dir_i];
+            std::optional<NodeId> jump_point = this->jump_from(node, dx, dz);
+            if(!jump_point.has_value()) { continue; }
+            // jumps are either fully straight or fully diagonal
+            u64 steps = (u64) std::max(
+                std::abs((i64) jump_point->first - x), 
+                std::abs((i64) jump_point->second - z)
+            );
+            u64 step_cost = dx != 0 && dz != 0
+                ? TilePassability::cost_daigo : TilePassability::cost_ortho;
+            out.push_back({ *jump_point, steps * step_cost });
+        }
+    }
+
+    void TileSnapshotNetwork::expand_jumps(
+        NodeId start, std::vector<NodeId>& points
+    ) {
+        std::vector<NodeId> jump_points = std::move(points);
+        points.clear();
+        NodeId current = start;
+        for(NodeId jump_point: jump_points) {
+            while(current != jump_point) {
+                if(current.first < jump_point.first) { current.first += 1; }
+                if(current.first > jump_point.first) { current.first -= 1; }
+                if(current.second < jump_point.second) { current.second += 1; }
+                if(current.second > jump_point.second) { current.second -= 1; }
+                points.push_back(current);
+            }
+        }
+    }
+
+    u64 TileSnapshotNetwork::node_target_dist(
+        NodeId node, ComplexId target
+    ) const {
+        (void) target;
+        auto [nx, nz] = node;
+        // same as 'Complex::closest_member_to'
+        f64 min_distance = INFINITY;
+        const TargetFootprint* closest = nullptr;
+        for(const TargetFootprint& footprint: this->snapshot->footprints) {
+            Vec<2> difference = Vec<2>(footprint.start_x, footprint.start_z)
+                - Vec<2>(nx, nz);
+            f64 distance = difference.len();
+            if(distance >= min_distance) { continue; }
+            min_distance = distance;
+            closest = &footprint;
+        }
+        return closest->manhattan_dist(nx, nz);
+    }
+
+}
@@ -43,7 +43,10 @@ namespace houseofatmos::world {
             || (pc_to_high + c_to_center).len() <= max_piece_dir_diff;
     }
 
-    void TrackNetwork::find_connections(NodeId node_id, Node& node_data) {
+    void TrackNetwork::find_connections(
+        NodeId node_id, 
+        std::vector<NodeId>& low_out, std::vector<NodeId>& high_out
+    ) {
         const TrackPiece& node = this->track_piece_at(node_id);
         u64 tiles_per_chunk = this->terrain->tiles_per_chunk();
         u64 world_wch = this->terrain->width_in_chunks();
@@ -61,7 +64,7 @@ namespace houseofatmos::world {
         u64 max_chx = std::min((node_tx + 1) / tiles_per_chunk, world_wch - 1);
         u64 max_chz = std::min((node_tz + 1) / tiles_per_chunk, world_hch - 1);
         for(u64 conn_chx = min_chx; conn_chx <= max_chx; conn_chx += 1) {
-            for(u64 conn_chz = min_chz; conn_chz <= max_chz + 1; conn_chz += 1) {
+            for(u64 conn_chz = min_chz; conn_chz <= max_chz; conn_chz += 1) {
                 const Terrain::ChunkData& conn_chunk = this->terrain
                     ->chunk_at(conn_chx, conn_chz);
                 for(size_t pc_i = 0; pc_i < conn_chunk.track_pieces.size(); pc_i += 1) {
@@ -85,7 +88,7 @@ namespace houseofatmos::world {
                         node_pts[0], node_inst
                     );
                     if(connected_low) { 
-                        node_data.connected_low.push_back(
+                        low_out.push_back(
                             TrackPieceId(conn_chx, conn_chz, pc_i)
                         ); 
                     }
@@ -99,7 +102,7 @@ namespace houseofatmos::world {
                         node_pts.back(), node_inst
                     );
                     if(connected_high) {
-                        node_data.connected_high.push_back(
+                        high_out.push_back(
                             TrackPieceId(conn_chx, conn_chz, pc_i)
                         );
                     }
@@ -125,7 +128,7 @@ namespace houseofatmos::world {
             const TrackPiece& piece = chunk.track_pieces[pc_i];
             if(piece.x != crx || piece.z != crz) { continue; }
             auto piece_id = TrackPieceId(cx, cz, pc_i);
-            if(this->graph.at(piece_id).block != nullptr) { return; }
+            if(this->node_at(piece_id).block != nullptr) { return; }
             is_conflict |= piece.direction == TrackPiece::Any;
             pieces.push_back(piece_id);
         }
@@ -144,18 +147,18 @@ namespace houseofatmos::world {
         block->size += 1;
         u64 tpc = this->terrain->tiles_per_chunk();
         for(const TrackPieceId& piece_id: pieces) {
-            Node& node = this->graph.at(piece_id);
+            Node& node = this->node_at(piece_id);
             // this assignment doesn't need to be in a separate loop
             // since the above checks stop if ANY track piece on the
             // same tile already has an assigned block
             node.block = block;
-            for(NodeId conn: node.connected_low) {
+            for(NodeId conn: this->connected_low(node)) {
                 const TrackPiece& conn_piece = this->track_piece_at(conn);
                 u64 ctx = conn.chunk_x * tpc + conn_piece.x;
                 u64 ctz = conn.chunk_z * tpc + conn_piece.z;
                 this->assign_nodes_to_blocks({ ctx, ctz }, node.block);
             }
-            for(NodeId conn: node.connected_high) {
+            for(NodeId conn: this->connected_high(node)) {
                 const TrackPiece& conn_piece = this->track_piece_at(conn);
                 u64 ctx = conn.chunk_x * tpc + conn_piece.x;
                 u64 ctz = conn.chunk_z * tpc + conn_piece.z;
@@ -167,14 +170,18 @@ namespace houseofatmos::world {
     static const f64 signal_track_dist = 2.0;
     static const Vec<3> signal_model_dir = Vec<3>(0, 0, 1);
 
-    void TrackNetwork::create_signals(NodeId node_i) {
-        const Node& node = this->graph.at(node_i);
+    void TrackNetwork::create_signals(
+        NodeId node_i, const std::unordered_set<const Block*>* only_touching
+    ) {
+        const Node& node = this->node_at(node_i);
         const TrackPiece& piece = this->track_piece_at(node_i);
-        const std::vector<NodeId>* connected = nullptr;
+        std::span<const NodeId> connected;
         switch(piece.direction) {
             case TrackPiece::Any: return; // conflict
-            case TrackPiece::Ascending: connected = &node.connected_high; break;
-            case TrackPiece::Descending: connected = &node.connected_low; break;
+            case TrackPiece::Ascending: 
+                connected = this->connected_high(node); break;
+            case TrackPiece::Descending: 
+                connected = this->connected_low(node); break;
             default: engine::error("Unhandled 'TrackPiece::Direction'!");
         }
         u64 tiles_per_chunk = this->terrain->tiles_per_chunk();
@@ -187,10 +194,14 @@ namespace houseofatmos::world {
         Vec<3> low = (inst * piece_points[0].with(1)).swizzle<3>("xyz");
         Vec<3> high = (inst * piece_points.back().with(1)).swizzle<3>("xyz");
         Vec<3> pos = (high - low) / 2 + low;
-        for(NodeId c_node_i: *connected) {
-            const Node& c_node = this->graph.at(c_node_i);
+        for(NodeId c_node_i: connected) {
+            const Node& c_node = this->node_at(c_node_i);
             const TrackPiece& c_piece = this->track_piece_at(c_node_i);
             if(c_node.block == node.block) { continue; }
+            bool skipped = only_touching != nullptr
+                && !only_touching->contains(node.block)
+                && !only_touching->contains(c_node.block);
+            if(skipped) { continue; }
             u64 c_tx = c_node_i.chunk_x * tiles_per_chunk + c_piece.x;
             u64 c_tz = c_node_i.chunk_z * tiles_per_chunk + c_piece.z;
             Vec<3> c_pos = Vec<3>(c_tx + 0.5, 0, c_tz + 0.5) * units_per_tile
@@ -208,19 +219,78 @@ namespace houseofatmos::world {
         }
     }
 
+    void TrackNetwork::build_chunk_offsets() {
+        u64 world_w_ch = this->terrain->width_in_chunks();
+        u64 world_h_ch = this->terrain->height_in_chunks();
+        this->chunk_offsets.resize(world_w_ch * world_h_ch + 1);
+        u32 node_count = 0;
+        for(u64 chunk_z = 0; chunk_z < world_h_ch; chunk_z += 1) {
+            for(u64 chunk_x = 0; chunk_x < world_w_ch; chunk_x += 1) {
+                const Terrain::ChunkData& chunk = this->terrain
+                    ->chunk_at(chunk_x, chunk_z);
+                this->chunk_offsets[chunk_x + chunk_z * world_w_ch] = node_count;
+                node_count += (u32) chunk.track_pieces.size();
+            }
+        }
+        this->chunk_offsets.back() = node_count;
+        this->nodes.assign(node_count, Node());
+    }
+
+    void TrackNetwork::push_node(
+        NodeId node_id, 
+        std::span<const NodeId> low, std::span<const NodeId> high
+    ) {
+        Node& node = this->node_at(node_id);
+        node.low_start = (u32) this->connections.size();
+        this->connections.insert(this->connections.end(), low.begin(), low.end());
+        node.high_start = (u32) this->connections.size();
+        this->connections.insert(this->connections.end(), high.begin(), high.end());
+        node.high_end = (u32) this->connections.size();
+    }
+
+    std::optional<TrackPieceId> TrackNetwork::first_piece_on_tile(
+        NodeId node_id
+    ) const {
+        const Terrain::ChunkData& chunk = this->terrain
+            ->chunk_at(node_id.chunk_x, node_id.chunk_z);
+        const TrackPiece& piece = chunk.track_pieces[node_id.piece_i];
+        for(size_t pc_i = 0; pc_i < chunk.track_pieces.size(); pc_i += 1) {
+            const TrackPiece& other = chunk.track_pieces[pc_i];
+            if(other.x != piece.x || other.z != piece.z) { continue; }
+            return TrackPieceId(node_id.chunk_x, node_id.chunk_z, pc_i);
+        }
+        return std::nullopt;
+    }
+
     void TrackNetwork::reset() {
-        this->graph.clear();
         u64 world_w_ch = this->terrain->width_in_chunks();
         u64 world_h_ch = this->terrain->height_in_chunks();
-        for(u64 chunk_x = 0; chunk_x < world_w_ch; chunk_x += 1) {
-            for(u64 chunk_z = 0; chunk_z < world_h_ch; chunk_z += 1) {
+        bool full_rebuild = this->modified_areas.empty()
+            || this->chunk_offsets.size() != world_w_ch * world_h_ch + 1;
+        if(full_rebuild) {
+            this->rebuild_all();
+        } else {
+            this->rebuild_modified();
+        }
+        this->modified_areas.clear();
+    }
+
+    void TrackNetwork::rebuild_all() {
+        u64 world_w_ch = this->terrain->width_in_chunks();
+        u64 world_h_ch = this->terrain->height_in_chunks();
+        this->build_chunk_offsets();
+        this->connections.clear();
+        std::vector<NodeId> low, high;
+        for(u64 chunk_z = 0; chunk_z < world_h_ch; chunk_z += 1) {
+            for(u64 chunk_x = 0; chunk_x < world_w_ch; chunk_x += 1) {
                 const Terrain::ChunkData& chunk = this->terrain
                     ->chunk_at(chunk_x, chunk_z);
                 for(size_t pc_i = 0; pc_i < chunk.track_pieces.size(); pc_i += 1) {
-                    auto node = Node({}, {});
                     auto node_id = TrackPieceId(chunk_x, chunk_z, pc_i);
-                    this->find_connections(node_id, node);
-                    this->graph[node_id] = node;
+                    this->find_connections(node_id, low, high);
+                    this->push_node(node_id, low, high);
+                    low.clear();
+                    high.clear();
                 }
             }
         }
@@ -257,15 +327,182 @@ namespace houseofatmos::world {
         }
     }
 
+    static std::vector<bool> expand_chunk_mask(
+        const std::vector<bool>& mask, u64 width, u64 height, u64 by
+    ) {
+        std::vector<bool> expanded = std::vector<bool>(mask.size(), false);
+        for(u64 chunk_z = 0; chunk_z < height; chunk_z += 1) {
+            for(u64 chunk_x = 0; chunk_x < width; chunk_x += 1) {
+                if(!mask[chunk_x + chunk_z * width]) { continue; }
+                u64 min_x = chunk_x > by? chunk_x - by : 0;
+                u64 min_z = chunk_z > by? chunk_z - by : 0;
+                u64 max_x = std::min(chunk_x + by, width - 1);
+                u64 max_z = std::min(chunk_z + by, height - 1);
+                for(u64 z = min_z; z <= max_z; z += 1) {
+                    for(u64 x = min_x; x <= max_x; x += 1) {
+                        expanded[x + z * width] = true;
+                    }
+                }
+            }
+        }
+        return expanded;
+    }
+
+    void TrackNetwork::rebuild_modified() {
+        u64 world_w_ch = this->terrain->width_in_chunks();
+        u64 world_h_ch = this->terrain->height_in_chunks();
+        u64 tpc = this->terrain->tiles_per_chunk();
+        // chunks containing modified tiles or their direct neighbours
+        // (piece IDs inside of these may have shifted)
+        std::vector<bool> modified 
+            = std::vector<bool>(world_w_ch * world_h_ch, false);
+        for(const ModifiedArea& area: this->modified_areas) {
+            u64 min_ch_x = (area.min_x > 0? area.min_x - 1 : 0) / tpc;
+            u64 min_ch_z = (area.min_z > 0? area.min_z - 1 : 0) / tpc;
+            u64 max_ch_x = std::min((area.max_x + 1) / tpc, world_w_ch - 1);
+            u64 max_ch_z = std::min((area.max_z + 1) / tpc, world_h_ch - 1);
+            for(u64 chunk_z = min_ch_z; chunk_z <= max_ch_z; chunk_z += 1) {
+                for(u64 chunk_x = min_ch_x; chunk_x <= max_ch_x; chunk_x += 1) {
+                    modified[chunk_x + chunk_z * world_w_ch] = true;
+                }
+            }
+        }
+        // connections only span neighbouring tiles, meaning only pieces in 
+        // neighbouring chunks may refer to pieces in modified chunks
+        std::vector<bool> reconnected = expand_chunk_mask(
+            modified, world_w_ch, world_h_ch, 1
+        );
+        // pieces of all other chunks are copied by their index, which is only
+        // possible if no pieces were added to or removed from them
+        for(size_t chunk_i = 0; chunk_i < reconnected.size(); chunk_i += 1) {
+            if(reconnected[chunk_i]) { continue; }
+            const Terrain::ChunkData& chunk = this->terrain->chunk_at(
+                chunk_i % world_w_ch, chunk_i / world_w_ch
+            );
+            u64 old_count = this->chunk_offsets[chunk_i + 1] 
+                - this->chunk_offsets[chunk_i];
+            if(chunk.track_pieces.size() == old_count) { continue; }
+            this->rebuild_all();
+            return;
+        }
+        // blocks may reach into chunks further away
+        u64 block_reach = (max_block_size - 1 + tpc - 1) / tpc;
+        std::vector<bool> reassigned = expand_chunk_mask(
+            reconnected, world_w_ch, world_h_ch, block_reach
+        );
+        std::unordered_set<const Block*> dissolved;
+        for(size_t chunk_i = 0; chunk_i < reconnected.size(); chunk_i += 1) {
+            if(!reconnected[chunk_i]) { continue; }
+            u32 end = this->chunk_offsets[chunk_i + 1];
+            for(u32 node_i = this->chunk_offsets[chunk_i]; node_i < end; node_i += 1) {
+                dissolved.insert(this->nodes[node_i].block);
+            }
+        }
+        // rebuild the node arrays, only finding connections of reconnected
+        // pieces and copying everything else
+        std::vector<u32> old_offsets = std::move(this->chunk_offsets);
+        std::vector<Node> old_nodes = std::move(this->nodes);
+        std::vector<NodeId> old_connections = std::move(this->connections);
+        this->build_chunk_offsets();
+        this->connections.clear();
+        this->connections.reserve(old_connections.size());
+        std::vector<NodeId> low, high;
+        for(u64 chunk_z = 0; chunk_z < world_h_ch; chunk_z += 1) {
+            for(u64 chunk_x = 0; chunk_x < world_w_ch; chunk_x += 1) {
+                u64 chunk_i = chunk_x + chunk_z * world_w_ch;
+                const Terrain::ChunkData& chunk = this->terrain
+                    ->chunk_at(chunk_x, chunk_z);
+                for(size_t pc_i = 0; pc_i < chunk.track_pieces.size(); pc_i += 1) {
+                    auto node_id = TrackPieceId(chunk_x, chunk_z, pc_i);
+                    if(reconnected[chunk_i]) {
+                        this->find_connections(node_id, low, high);
+                        this->push_node(node_id, low, high);
+                        low.clear();
+                        high.clear();
+                        continue;
+                    }
+                    const Node& old = old_nodes[old_offsets[chunk_i] + pc_i];
+                    const NodeId* old_conns = old_connections.data();
+                    this->push_node(
+                        node_id,
+                        std::span<const NodeId>(
+                            old_conns + old.low_start, 
+                            old_conns + old.high_start
+                        ),
+                        std::span<const NodeId>(
+                            old_conns + old.high_start, 
+                            old_conns + old.high_end
+                        )
+                    );
+                    bool keep_block = !reassigned[chunk_i]
+                        || !dissolved.contains(old.block);
+                    if(keep_block) { this->node_at(node_id).block = old.block; }
+                }
+            }
+        }
+        this->blocks.remove_if([&](const Block& block) {
+            return dissolved.contains(&block);
+        });
+        std::erase_if(this->signals, [&](const Signal& signal) {
+            return dissolved.contains(signal.from) 
+                || dissolved.contains(signal.to);
+        });
+        // all ownership is lost on reset, even for blocks that are kept
+        for(Block& block: this->blocks) { block.owner = nullptr; }
+        // assign all pieces that are now without a block to new blocks
+        std::vector<NodeId> unassigned;
+        for(u64 chunk_x = 0; chunk_x < world_w_ch; chunk_x += 1) {
+            for(u64 chunk_z = 0; chunk_z < world_h_ch; chunk_z += 1) {
+                if(!reassigned[chunk_x + chunk_z * world_w_ch]) { continue; }
+                const Terrain::ChunkData& chunk = this->terrain
+                    ->chunk_at(chunk_x, chunk_z);
+                for(size_t pc_i = 0; pc_i < chunk.track_pieces.size(); pc_i += 1) {
+                    auto node_id = TrackPieceId(chunk_x, chunk_z, pc_i);
+                    if(this->node_at(node_id).block != nullptr) { continue; }
+                    unassigned.push_back(node_id);
+                }
+            }
+        }
+        for(NodeId node_id: unassigned) {
+            const TrackPiece& piece = this->track_piece_at(node_id);
+            u64 ptx = node_id.chunk_x * tpc + piece.x;
+            u64 ptz = node_id.chunk_z * tpc + piece.z;
+            this->assign_nodes_to_blocks({ ptx, ptz });
+        }
+        // create the signals at the borders of the new blocks
+        std::unordered_set<const Block*> created;
+        for(NodeId node_id: unassigned) {
+            created.insert(this->node_at(node_id).block);
+        }
+        std::unordered_set<TileNetworkNode::NodeId, TileNetworkNode::NodeIdHash>
+            signalled_tiles;
+        auto signal_tile_of = [&](NodeId node_id) {
+            std::optional<NodeId> first = this->first_piece_on_tile(node_id);
+            if(!first.has_value()) { return; }
+            const TrackPiece& piece = this->track_piece_at(*first);
+            u64 ptx = first->chunk_x * tpc + piece.x;
+            u64 ptz = first->chunk_z * tpc + piece.z;
+            TileNetworkNode::NodeId tile = { ptx, ptz };
+            if(signalled_tiles.contains(tile)) { return; }
+            this->create_signals(*first, &created);
+            signalled_tiles.insert(tile);
+        };
+        for(NodeId node_id: unassigned) {
+            signal_tile_of(node_id);
+            const Node& node = this->node_at(node_id);
+            for(NodeId conn: this->connected_low(node)) { signal_tile_of(conn); }
+            for(NodeId conn: this->connected_high(node)) { signal_tile_of(conn); }
+        }
+    }
 
     void TrackNetwork::collect_next_nodes(
         std::optional<NodeId> prev, NodeId node_i, 
         std::vector<std::pair<NodeId, u64>>& out
     ) {
-        Node node = this->graph[node_i];
+        const Node& node = this->node_at(node_i);
         const TrackPiece& piece = this->track_piece_at(node_i);
-        const std::vector<NodeId>& low = node.connected_low;
-        const std::vector<NodeId>& high = node.connected_high;
+        std::span<const NodeId> low = this->connected_low(node);
+        std::span<const NodeId> high = this->connected_high(node);
         // previous piece is connected at LOW end of this piece?
         // -> connects to all pieces at HIGH end
         bool prev_at_low = !prev.has_value()
@@ -404,13 +641,11 @@ namespace houseofatmos::world {
             }
             pos.piece_id = path.points[pt_i];
             pos.distance = 0.0;
-            const TrackNetwork::Node& next_node 
-                = network.graph.at(pos.piece_id);
+            std::span<const TrackPieceId> next_low = network
+                .connected_low(network.node_at(pos.piece_id));
             bool is_ascending = std::find(
-                next_node.connected_low.begin(), 
-                next_node.connected_low.end(),
-                piece_id
-            ) != next_node.connected_low.end();
+                next_low.begin(), next_low.end(), piece_id
+            ) != next_low.end();
             pos.direction = is_ascending
                 ? TrackPiece::Direction::Ascending 
                 : TrackPiece::Direction::Descending;
@@ -449,13 +684,11 @@ namespace houseofatmos::world {
             f64 next_piece_len = TrackPiece::types()
                 .at((size_t) next_piece.type).length();
             pos.distance = next_piece_len;
-            const TrackNetwork::Node& next_node 
-                = network.graph.at(pos.piece_id);
+            std::span<const TrackPieceId> next_high = network
+                .connected_high(network.node_at(pos.piece_id));
             bool is_ascending = std::find(
-                next_node.connected_high.begin(), 
-                next_node.connected_high.end(),
-                prev_piece_id
-            ) != next_node.connected_high.end();
+                next_high.begin(), next_high.end(), prev_piece_id
+            ) != next_high.end();
             pos.direction = is_ascending
                 ? TrackPiece::Direction::Ascending 
                 : TrackPiece::Direction::Descending;
@@ -677,7 +910,7 @@ namespace houseofatmos::world {
         f64 distance = this->cars.front().first.remaining(network);
         for(size_t p = front_point_i + 1; p < path.points.size(); p += 1) {
             TrackPieceId piece_id = path.points[p];
-            const TrackNetwork::Node& node = network.graph.at(piece_id);
+            const TrackNetwork::Node& node = network.node_at(piece_id);
             if(node.block->owner != this) { 
                 // distance to next unowned block
                 return distance - 3.0; // wait a bit before the next block
@@ -731,7 +964,7 @@ namespace houseofatmos::world {
         }
         for(size_t p = back_point_i; p < path.points.size(); p += 1) {
             TrackPieceId piece_id = path.points[p];
-            const TrackNetwork::Node& node = network.graph.at(piece_id);
+            const TrackNetwork::Node& node = network.node_at(piece_id);
             if(node.block->owner != this) { continue; }
             auto owned_block = std::find_if(
                 this->owning_blocks.begin(), this->owning_blocks.end(), 
@@ -766,13 +999,13 @@ namespace houseofatmos::world {
             engine::warning("take_next_blocks: Train broken! Current segments are not in path");
             return;
         }
-        TrackNetwork::Block* current_block = network.graph
-            .at(path.points[front_point_i]).block;
+        TrackNetwork::Block* current_block = network
+            .node_at(path.points[front_point_i]).block;
         if(current_block->owner != this) { current_block = nullptr; }
         bool may_take_all = true;
         for(size_t p = front_point_i + 1; p < path.points.size(); p += 1) {
             TrackPieceId piece_id = path.points[p];
-            const TrackNetwork::Node& node = network.graph.at(piece_id);
+            const TrackNetwork::Node& node = network.node_at(piece_id);
             if(node.block == current_block) { continue; }
             may_take_all &= node.block->owner == nullptr;
             if(node.block->type == TrackNetwork::Block::Conflict) { continue; }
@@ -781,7 +1014,7 @@ namespace houseofatmos::world {
         if(!may_take_all) { return; }
         for(size_t p = front_point_i + 1; p < path.points.size(); p += 1) {
             TrackPieceId piece_id = path.points[p];
-            const TrackNetwork::Node& node = network.graph.at(piece_id);
+            const TrackNetwork::Node& node = network.node_at(piece_id);
             if(node.block == current_block) { continue; }
             node.block->owner = this;
             this->owning_blocks.push_back(OwnedBlock(node.block, true));
@@ -826,6 +1059,19 @@ namespace houseofatmos::world {
         this->owning_blocks.clear();
     }
 
+    void Train::on_piece_removed(TrackPieceId removed) {
+        auto shift = [&](TrackPieceId& piece_id) {
+            bool shifted = piece_id.chunk_x == removed.chunk_x
+                && piece_id.chunk_z == removed.chunk_z
+                && piece_id.piece_i > removed.piece_i;
+            if(shifted) { piece_id.piece_i -= 1; }
+        };
+        for(CarPosition& car_pos: this->cars) {
+            shift(car_pos.first.piece_id);
+            shift(car_pos.second.piece_id);
+        }
+    }
+
     void Train::update_velocity(
         const engine::Window& window, TrackNetwork& network
     ) {
@@ -6,6 +6,8 @@
 #include "tile_network.hpp"
 #include "../research/research.hpp"
 #include <algorithm>
+#include <span>
+#include <unordered_set>
 
 namespace houseofatmos::world {
 
@@ -41,6 +43,7 @@ namespace houseofatmos::world {
                 return r;
             }
         };
+        using SearchStates = HashedSearchStates<NodeId, NodeIdHash>;
     };
 
     struct TrackNetwork: AgentNetwork<TrackNetworkNode> {
@@ -155,9 +158,12 @@ namespace houseofatmos::world {
             }
         };
 
+        // The pieces connected to a node are stored in 'connections', 
+        // first all connected at the low end, then all at the high end.
         struct Node {
-            std::vector<NodeId> connected_low;
-            std::vector<NodeId> connected_high;
+            u32 low_start = 0;
+            u32 high_start = 0;
+            u32 high_end = 0;
             Block* block = nullptr;
         };
         
@@ -166,7 +172,44 @@ namespace houseofatmos::world {
         StatefulRNG rng;
         std::list<Block> blocks;
         std::vector<Signal> signals;
-        std::unordered_map<NodeId, Node, NodeIdHash> graph;
+
+        private:
+        // The node of a piece is at index 'chunk_offsets[chunk] + piece_i'
+        // (chunks ordered by Z, then X). 
+        std::vector<u32> chunk_offsets;
+        std::vector<Node> nodes;
+        std::vector<NodeId> connections;
+
+        size_t node_index(NodeId node) const {
+            size_t chunk_i = node.chunk_x 
+                + node.chunk_z * this->terrain->width_in_chunks();
+            size_t node_i = this->chunk_offsets[chunk_i] + node.piece_i;
+            if(node_i >= this->chunk_offsets[chunk_i + 1]) {
+                engine::error("Track piece is not part of the network!");
+            }
+            return node_i;
+        }
+
+        public:
+        Node& node_at(NodeId node) { 
+            return this->nodes[this->node_index(node)]; 
+        }
+        const Node& node_at(NodeId node) const { 
+            return this->nodes[this->node_index(node)]; 
+        }
+
+        std::span<const NodeId> connected_low(const Node& node) const {
+            return std::span<const NodeId>(
+                this->connections.data() + node.low_start,
+                this->connections.data() + node.high_start
+            );
+        }
+        std::span<const NodeId> connected_high(const Node& node) const {
+            return std::span<const NodeId>(
+                this->connections.data() + node.high_start,
+                this->connections.data() + node.high_end
+            );
+        }
 
         TrackNetwork(
             const Settings* settings, Terrain* terrain, ComplexBank* complexes
@@ -178,14 +221,30 @@ namespace houseofatmos::world {
 
 
         private:
-        void find_connections(NodeId node, Node& node_data);
+        void find_connections(
+            NodeId node, 
+            std::vector<NodeId>& low_out, std::vector<NodeId>& high_out
+        );
         void assign_nodes_to_blocks(
             TileNetwork::NodeId tile,
             Block* previous = nullptr
         );
-        void create_signals(NodeId node);
+        void create_signals(
+            NodeId node, 
+            const std::unordered_set<const Block*>* only_touching = nullptr
+        );
+        void build_chunk_offsets();
+        void push_node(
+            NodeId node, 
+            std::span<const NodeId> low, std::span<const NodeId> high
+        );
+        std::optional<NodeId> first_piece_on_tile(NodeId node) const;
+        void rebuild_all();
+        void rebuild_modified();
         
         public:
+        // Only rebuilds the parts of the network near the areas marked using
+        // 'mark_modified', unless none have been marked.
         void reset() override;
 
         void collect_next_nodes(
@@ -397,6 +456,10 @@ namespace houseofatmos::world {
 
         void on_network_reset(TrackNetwork& network) override;
 
+        // must be called after a track piece has been removed from a chunk,
+        // since the IDs of the pieces after it in that chunk shift down
+        void on_piece_removed(TrackPieceId removed);
+
         void update_velocity(
             const engine::Window& window, TrackNetwork& network
         );
@@ -441,13 +441,13 @@ namespace houseofatmos::world {
     ) {
         this->trigger_autosave(window, toasts);
         this->carriages.update(
-            scene, window, particles, this->player, interactables
+            scene, window, particles, this->player, interactables, toasts
         );
         this->trains.update(
-            scene, window, particles, this->player, interactables
+            scene, window, particles, this->player, interactables, toasts
         );
         this->boats.update(
-            scene, window, particles, this->player, interactables
+            scene, window, particles, this->player, interactables, toasts
         );
         this->complexes.update(
             window, this->balance, this->research, this->terrain, 
@@ -0,0 +1,115 @@
+
+#include "../src/world/tile_network.hpp"
+#include <iostream>
+#include <random>
+
+using namespace houseofatmos;
+using namespace houseofatmos::world;
+
+using NodeId = TileSnapshotNetwork::NodeId;
+
+
+static const u64 grid_size = 64;
+static const u64 grid_count = 32;
+static const u64 searches_per_grid = 16;
+
+
+// total cost of moving from 'start' along the given points, or std::nullopt
+// if the path contains a step that is not a move onto a passable neighbour
+static std::optional<u64> path_cost(
+    const TilePassability& passability, NodeId start,
+    const std::vector<NodeId>& points
+) {
+    u64 cost = 0;
+    NodeId current = start;
+    for(NodeId point: points) {
+        u64 dx = std::max(current.first, point.first)
+            - std::min(current.first, point.first);
+        u64 dz = std::max(current.second, point.second)
+            - std::min(current.second, point.second);
+        if(dx > 1 || dz > 1 || dx + dz == 0) { return std::nullopt; }
+        if(!passability.at(point)) { return std::nullopt; }
+        cost += dx != 0 && dz != 0
+            ? TilePassability::cost_daigo : TilePassability::cost_ortho;
+        current = point;
+    }
+    return cost;
+}
+
+static std::optional<u64> search_cost(
+    TileSearchSnapshot& snapshot, NodeId start, bool jump, bool& valid
+) {
+    snapshot.uniform_costs = jump;
+    std::optional<std::vector<NodeId>> points
+        = TileSnapshotNetwork::search(snapshot, start);
+    if(!points.has_value()) { return std::nullopt; }
+    std::optional<u64> cost = path_cost(*snapshot.passability, start, *points);
+    if(!cost.has_value()) { valid = false; }
+    return cost;
+}
+
+int main() {
+    auto rng = std::mt19937(12345);
+    auto tile_coord = std::uniform_int_distribution<u64>(0, grid_size - 1);
+    auto obstacle_chance = std::uniform_real_distribution<f64>(0.0, 0.4);
+    auto chance = std::uniform_real_distribution<f64>(0.0, 1.0);
+    u64 failures = 0;
+    u64 found = 0;
+    for(u64 grid_i = 0; grid_i < grid_count; grid_i += 1) {
+        auto passability = std::make_shared<TilePassability>(
+            grid_size, grid_size
+        );
+        f64 blocked = obstacle_chance(rng);
+        for(u64 x = 0; x < grid_size; x += 1) {
+            for(u64 z = 0; z < grid_size; z += 1) {
+                passability->set({ x, z }, chance(rng) >= blocked);
+            }
+        }
+        // walls with a single gap to force detours
+        for(u64 wall_x = 16; wall_x < grid_size; wall_x += 16) {
+            u64 gap_z = tile_coord(rng);
+            for(u64 z = 0; z < grid_size; z += 1) {
+                passability->set({ wall_x, z }, z == gap_z);
+            }
+        }
+        for(u64 search_i = 0; search_i < searches_per_grid; search_i += 1) {
+            auto snapshot = TileSearchSnapshot();
+            snapshot.passability = passability;
+            snapshot.target = ComplexId { 0 };
+            u64 target_x = std::min(tile_coord(rng), grid_size - 3);
+            u64 target_z = std::min(tile_coord(rng), grid_size - 3);
+            snapshot.footprints.push_back(TargetFootprint(
+                target_x, target_z, target_x + 2, target_z + 2
+            ));
+            snapshot.max_target_dist = 1;
+            snapshot.tiles_per_chunk = 8;
+            snapshot.width_chunks = grid_size / 8;
+            auto start = NodeId(tile_coord(rng), tile_coord(rng));
+            if(!passability->at(start)) { continue; }
+            bool valid = true;
+            std::optional<u64> astar = search_cost(snapshot, start, false, valid);
+            std::optional<u64> jps = search_cost(snapshot, start, true, valid);
+            std::vector<u32> dist = TileSnapshotNetwork::distances(snapshot);
+            u32 field = dist[start.first + start.second * grid_size];
+            std::optional<u64> field_cost = field == UINT32_MAX
+                ? std::nullopt : std::optional<u64>(field);
+            if(valid && astar == jps && astar == field_cost) {
+                if(astar.has_value()) { found += 1; }
+                continue;
+            }
+            failures += 1;
+            auto show = [](std::optional<u64> cost) {
+                return cost.has_value()? std::to_string(*cost) : "none";
+            };
+            std::cerr << "grid " << grid_i << ", search " << search_i
+                << " from (" << start.first << ", " << start.second << ")"
+                << " to (" << target_x << ", " << target_z << "): "
+                << "A* " << show(astar) << ", JPS " << show(jps)
+                << ", distance field " << show(field_cost)
+                << (valid? "" : " (invalid path)") << std::endl;
+        }
+    }
+    std::cout << found << " paths found, " << failures << " mismatches"
+        << std::endl;
+    return failures == 0? 0 : 1;
+}
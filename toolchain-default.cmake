@@ -11,6 +11,7 @@ set(REQUIRED_PACKAGES
     OpenGL
     glfw3
     OpenAL
+    Threads
 )
 
 set(LINKED_LIBS
@@ -18,6 +19,7 @@ set(LINKED_LIBS
     ${EGL_LIBRARIES}
     glfw
     OpenAL::OpenAL
+    Threads::Threads
 )
 set(LINKER_OPTIONS "")
 set(OUT_NAME "house_of_atmos")
\ No newline at end of file